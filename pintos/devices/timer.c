@@ -5,6 +5,7 @@
 #include <stdio.h>
 #include "threads/interrupt.h"
 #include "threads/io.h"
+#include "threads/profile.h"
 #include "threads/synch.h"
 #include "threads/thread.h"
 #include <stdint.h>
@@ -25,7 +26,51 @@ static int64_t ticks;
    timer_calibrate()에 의해 초기화됨 */
 static unsigned loops_per_tick;
 
+/* 계층적 타이밍 휠.
+   각 레벨은 WHEEL_SIZE개의 슬롯을 가지며, 레벨 N의 슬롯 하나는
+   WHEEL_SIZE^N 틱을 담당합니다. 만료가 가까운 타이머는 레벨 0에,
+   먼 타이머는 상위 레벨에 들어가고, 하위 레벨이 한 바퀴 돌 때마다
+   상위 레벨의 슬롯 하나가 아래로 내려옵니다(cascade).
+   따라서 등록과 취소는 O(1)이고, 만료 처리도 타이머당 최대
+   WHEEL_LEVELS번의 이동만 필요합니다. */
+#define WHEEL_BITS 6
+#define WHEEL_SIZE (1 << WHEEL_BITS)
+#define WHEEL_MASK (WHEEL_SIZE - 1)
+#define WHEEL_LEVELS 4
+/* 휠이 직접 표현할 수 있는 가장 먼 만료 시각 (틱 단위 거리) */
+#define WHEEL_MAX_DELTA ((1LL << (WHEEL_BITS * WHEEL_LEVELS)) - 1)
+
+static struct list wheel[WHEEL_LEVELS][WHEEL_SIZE];
+
+/* 다음에 처리할 틱. 이 값보다 작은 틱의 슬롯은 모두 처리되었습니다. */
+static int64_t wheel_clock;
+
+/* 8254 PIT 입력 주파수 (Hz) */
+#define PIT_HZ 1193180
+
+/* 틱 하나에 해당하는 PIT 카운트. timer_init()에서 계산됩니다. */
+static uint16_t pit_count_per_tick;
+
+/* true이면 다른 쓰레드가 없을 때 주기적 틱을 멈춥니다.
+   커널 명령줄 옵션 "-tickless"로 제어됩니다. */
+bool timer_tickless;
+
+/* tickless 상태. idle 쓰레드가 PIT을 one-shot 모드로 바꿔 놓고
+   잠든 동안에만 tickless_active가 true입니다. */
+static bool tickless_active;
+static int64_t tickless_ticks;          /* one-shot으로 건너뛰려는 틱 수 */
+static uint16_t tickless_count;         /* one-shot으로 프로그래밍한 PIT 카운트 */
+static int64_t tickless_skipped;        /* 인터럽트 없이 지나간 틱 수 (통계) */
+static uint32_t tickless_carry;         /* 틱으로 세지 못하고 남은 PIT 카운트 */
+
 static intr_handler_func timer_interrupt;
+static void pit_program (uint8_t mode, uint16_t count);
+static void timer_catch_up (int64_t n);
+static int64_t wheel_next_expiry (void);
+static void wheel_insert (struct timer *);
+static int wheel_cascade (int level);
+static void wheel_run (void);
+static void sleep_wakeup (void *t_);
 static bool too_many_loops (unsigned loops);
 static void busy_wait (int64_t loops);
 static void real_time_sleep (int64_t num, int32_t denom);
@@ -37,11 +82,14 @@ void
 timer_init (void) {
 	/* 8254 입력 주파수를 TIMER_FREQ로 나누고 반올림 */
     // count = 11932
-	uint16_t count = (1193180 + TIMER_FREQ / 2) / TIMER_FREQ;
+	pit_count_per_tick = (PIT_HZ + TIMER_FREQ / 2) / TIMER_FREQ;
 
-	outb (0x43, 0x34);    /* CW: counter 0, LSB then MSB, mode 2, binary. */
-	outb (0x40, count & 0xff);
-	outb (0x40, count >> 8);
+	pit_program (2, pit_count_per_tick);    /* mode 2: rate generator */
+
+	for (int level = 0; level < WHEEL_LEVELS; level++)
+		for (int slot = 0; slot < WHEEL_SIZE; slot++)
+			list_init (&wheel[level][slot]);
+	wheel_clock = ticks;
 
 	intr_register_ext (0x20, timer_interrupt, "8254 Timer");
 }
@@ -100,16 +148,78 @@ timer_elapsed (int64_t then) {
 	return timer_ticks () - then;
 }
 
+/* 타이머 T를 초기화합니다. 만료되면 타이머 인터럽트 안에서
+   FUNC(AUX)가 호출됩니다. */
+void
+timer_setup (struct timer *t, timer_func *func, void *aux) {
+	ASSERT (t != NULL);
+	ASSERT (func != NULL);
+
+	t->expires = 0;
+	t->func = func;
+	t->aux = aux;
+	t->pending = false;
+}
+
+/* 타이머 T를 EXPIRES 틱에 만료되도록 등록합니다.
+   이미 등록된 타이머라면 새 만료 시각으로 옮깁니다.
+   EXPIRES가 이미 지났다면 다음 틱에 만료됩니다.
+   인터럽트 핸들러(타이머 콜백 포함)에서 호출될 수 있습니다. */
+void
+timer_add (struct timer *t, int64_t expires) {
+	ASSERT (t != NULL);
+	ASSERT (t->func != NULL);
+
+	enum intr_level old_level = intr_disable ();
+	if (t->pending)
+		list_remove (&t->elem);
+	t->expires = expires;
+	t->pending = true;
+	wheel_insert (t);
+	intr_set_level (old_level);
+}
+
+/* 등록된 타이머 T를 취소합니다. T가 대기 중이었으면 true를,
+   이미 만료되었거나 등록된 적이 없으면 false를 반환합니다. */
+bool
+timer_cancel (struct timer *t) {
+	ASSERT (t != NULL);
+
+	enum intr_level old_level = intr_disable ();
+	bool was_pending = t->pending;
+	if (was_pending) {
+		list_remove (&t->elem);
+		t->pending = false;
+	}
+	intr_set_level (old_level);
+
+	return was_pending;
+}
+
+/* 타이머 T가 아직 만료되지 않고 대기 중이면 true를 반환합니다. */
+bool
+timer_pending (const struct timer *t) {
+	ASSERT (t != NULL);
+	return t->pending;
+}
+
 /* 대략 TICKS 타이머 틱 동안 실행을 일시 중지합니다. */
 /* 타이머 틱에 대한 실행을 일시 중지합니다. */
 void
 timer_sleep (int64_t ticks) {
 	ASSERT (intr_get_level () == INTR_ON);
 	
-    if ( ticks == 0 ) return;
-    
-    /* project 1.1 alarm 의 busy_waiting 을 해결하기 위한 thread_sleep */
-    thread_sleep( timer_ticks() + ticks );
+    if ( ticks <= 0 ) return;
+
+    /* 스택에 타이머를 두고 만료 콜백에서 깨워달라고 한 뒤 잠듭니다.
+       timer_add 와 thread_block 사이에 만료되지 않도록 인터럽트를 끕니다. */
+    struct timer t;
+    timer_setup (&t, sleep_wakeup, thread_current ());
+
+    enum intr_level old_level = intr_disable ();
+    timer_add (&t, timer_ticks () + ticks);
+    thread_block ();
+    intr_set_level (old_level);
 }
 
 /* 대략 MS 밀리초 동안 실행을 일시 중지합니다. */
@@ -130,25 +240,248 @@ timer_nsleep (int64_t ns) {
 	real_time_sleep (ns, 1000 * 1000 * 1000);
 }
 
+/* idle 쓰레드가 hlt 하기 직전에 인터럽트가 꺼진 상태로 호출합니다.
+   tickless 모드라면 다음 타이머 만료 시각까지의 틱 수만큼 PIT을
+   one-shot 모드로 프로그래밍해서, 그 사이의 타이머 인터럽트를 생략합니다.
+   PIT 카운터는 16비트이고 입력 클럭은 1.19MHz로 고정이라 one-shot은
+   최대 약 55ms입니다. TIMER_FREQ가 100이면 한 번에 5틱까지만 건너뜁니다.
+   분주비를 바꿔도 이 한계는 늘지 않으며, 더 길게 재우려면 LAPIC
+   타이머나 HPET이 필요합니다. */
+void
+timer_idle_enter (void) {
+	ASSERT (intr_get_level () == INTR_OFF);
+
+	if (!timer_tickless || tickless_active)
+		return;
+
+	/* 다음에 처리해야 할 만료 시각까지 남은 틱 수.
+	   바로 다음 틱에 할 일이 있으면 건너뛸 것이 없습니다. */
+	int64_t max_ticks = UINT16_MAX / pit_count_per_tick;
+	int64_t next = wheel_next_expiry ();
+	int64_t n = next - ticks;
+	if (n > max_ticks)
+		n = max_ticks;
+	if (n <= 1)
+		return;
+
+	tickless_active = true;
+	tickless_ticks = n;
+	tickless_count = n * pit_count_per_tick;
+	pit_program (0, tickless_count);        /* mode 0: interrupt on terminal count */
+}
+
+/* tickless 상태에서 외부 인터럽트가 들어오면 핸들러보다 먼저 호출됩니다.
+   그동안 지나간 틱만큼 ticks와 쓰레드 통계를 따라잡고 PIT을 다시 주기 모드로
+   되돌립니다. TIMER_IRQ가 true이면 one-shot 타이머 자신의 인터럽트이므로,
+   마지막 틱은 곧 이어지는 timer_interrupt()가 처리합니다. */
+void
+timer_idle_exit (bool timer_irq) {
+	ASSERT (intr_get_level () == INTR_OFF);
+
+	if (!tickless_active)
+		return;
+	tickless_active = false;
+
+	int64_t elapsed;
+	if (timer_irq)
+		elapsed = tickless_ticks - 1;
+	else {
+		/* 카운터 0의 현재 값을 래치해서 읽습니다. mode 0은 0에 도달한 뒤에도
+		   0xffff부터 계속 감소하므로, 프로그래밍한 값보다 크면 이미 만료된
+		   것이고 대기 중인 IRQ0이 마지막 틱을 처리합니다. */
+		outb (0x43, 0x00);
+		uint16_t remain = inb (0x40);
+		remain |= inb (0x40) << 8;
+		if (remain == 0 || remain > tickless_count)
+			elapsed = tickless_ticks - 1;
+		else {
+			/* 틱 경계 사이에서 깨어났으면 남는 카운트를 다음 깨어남으로
+			   넘깁니다. 버리면 깨어날 때마다 틱 하나 미만씩 시계가
+			   늦어집니다. */
+			uint32_t counted = tickless_count - remain + tickless_carry;
+
+			elapsed = counted / pit_count_per_tick;
+			tickless_carry = counted % pit_count_per_tick;
+			if (elapsed > tickless_ticks - 1) {
+				elapsed = tickless_ticks - 1;
+				tickless_carry = 0;
+			}
+		}
+	}
+
+	pit_program (2, pit_count_per_tick);
+	timer_catch_up (elapsed);
+}
+
 /* 타이머 통계를 출력합니다. */
 void
 timer_print_stats (void) {
 	printf ("Timer: %"PRId64" ticks\n", timer_ticks ());
 }
 
+/* tickless idle 동안 인터럽트 없이 지나간 틱 수를 반환합니다. */
+int64_t
+timer_skipped_ticks (void) {
+	return tickless_skipped;
+}
+
 /* 타이머 인터럽트 핸들러 */
 static void
-timer_interrupt (struct intr_frame *args UNUSED) {
+timer_interrupt (struct intr_frame *args) {
 	ticks++;
-    
-    /* project 1.1 alarm으로 쓰레드를 wake up 시키기 위한 함수 */
-    if ( get_minimum_tick() <= ticks ) {
-        thread_wakeup();
-    } 
+
+	if (profile_interval != 0)
+		profile_sample (args);
+
+	/* 이번 틱까지 만료된 타이머의 콜백을 실행합니다. */
+	wheel_run ();
 
 	thread_tick ();
 }
 
+/* 8254 카운터 0을 MODE로 설정하고 COUNT를 적재합니다. */
+static void
+pit_program (uint8_t mode, uint16_t count) {
+	/* CW: counter 0, LSB then MSB, MODE, binary. */
+	outb (0x43, 0x30 | (mode << 1));
+	outb (0x40, count & 0xff);
+	outb (0x40, count >> 8);
+}
+
+/* 인터럽트 없이 지나간 N 틱을 한 틱씩 처리합니다. 만료된 타이머를 실행하고
+   thread_tick()을 불러 idle 통계와 스케줄러 계산이 주기 모드와 같게 유지되도록
+   합니다. 외부 인터럽트 컨텍스트에서 호출됩니다. */
+static void
+timer_catch_up (int64_t n) {
+	while (n-- > 0) {
+		ticks++;
+		tickless_skipped++;
+		wheel_run ();
+		thread_tick ();
+	}
+}
+
+/* timer_sleep()의 만료 콜백. 잠든 쓰레드를 깨우고, 깨어난 쓰레드의
+   우선순위가 더 높으면 인터럽트 리턴 시 양보합니다. */
+static void
+sleep_wakeup (void *t_) {
+	struct thread *t = t_;
+
+	thread_unblock (t);
+	thread_try_yield ();
+}
+
+/* 타이머 T를 만료 시각에 맞는 휠 슬롯에 넣습니다.
+   인터럽트가 꺼진 상태에서 호출되어야 합니다. */
+static void
+wheel_insert (struct timer *t) {
+	int64_t delta = t->expires - wheel_clock;
+	int level;
+	int64_t when;
+
+	ASSERT (intr_get_level () == INTR_OFF);
+
+	if (delta < 0) {
+		/* 이미 지난 타이머는 바로 다음에 처리할 슬롯에 넣습니다. */
+		level = 0;
+		when = wheel_clock;
+	} else {
+		/* 너무 먼 타이머는 최상위 레벨의 가장 먼 슬롯에 두고,
+		   cascade 될 때 다시 자리를 찾도록 합니다. */
+		if (delta > WHEEL_MAX_DELTA)
+			delta = WHEEL_MAX_DELTA;
+		when = wheel_clock + delta;
+		for (level = 0; level < WHEEL_LEVELS - 1; level++)
+			if (delta < 1LL << (WHEEL_BITS * (level + 1)))
+				break;
+	}
+
+	int slot = (when >> (WHEEL_BITS * level)) & WHEEL_MASK;
+	list_push_back (&wheel[level][slot], &t->elem);
+}
+
+/* LEVEL 레벨에서 현재 wheel_clock에 해당하는 슬롯의 타이머들을
+   한 단계 아래 레벨로 다시 배치하고, 그 슬롯 번호를 반환합니다.
+   반환값이 0이면 이 레벨도 한 바퀴를 돌았다는 뜻입니다. */
+static int
+wheel_cascade (int level) {
+	int slot = (wheel_clock >> (WHEEL_BITS * level)) & WHEEL_MASK;
+	struct list *bucket = &wheel[level][slot];
+
+	while (!list_empty (bucket)) {
+		struct timer *t = list_entry (list_pop_front (bucket), struct timer, elem);
+		wheel_insert (t);
+	}
+	return slot;
+}
+
+/* 휠에 있는 타이머 중 가장 먼저 처리해야 하는 틱을 반환합니다.
+   레벨 0은 정확한 만료 시각을, 상위 레벨은 그 슬롯이 아래로 내려오는
+   시각을 돌려주므로 실제 만료 시각보다 이를 수는 있어도 늦지는 않습니다.
+   대기 중인 타이머가 없으면 INT64_MAX를 반환합니다. */
+static int64_t
+wheel_next_expiry (void) {
+	int64_t next = INT64_MAX;
+
+	ASSERT (intr_get_level () == INTR_OFF);
+
+	for (int i = 0; i < WHEEL_SIZE; i++) {
+		int64_t when = wheel_clock + i;
+		if (!list_empty (&wheel[0][when & WHEEL_MASK])) {
+			next = when;
+			break;
+		}
+	}
+
+	for (int level = 1; level < WHEEL_LEVELS; level++) {
+		int shift = WHEEL_BITS * level;
+		/* 이 레벨의 다음 cascade 시각 (wheel_clock 이상인 2^shift의 배수) */
+		int64_t base = ((wheel_clock + (1LL << shift) - 1) >> shift) << shift;
+		for (int i = 0; i < WHEEL_SIZE; i++) {
+			int64_t when = base + ((int64_t) i << shift);
+			if (when >= next)
+				break;
+			if (!list_empty (&wheel[level][(when >> shift) & WHEEL_MASK])) {
+				next = when;
+				break;
+			}
+		}
+	}
+	return next;
+}
+
+/* wheel_clock부터 현재 틱까지의 슬롯을 차례로 처리하며 만료된
+   타이머의 콜백을 호출합니다. 타이머 인터럽트에서 호출됩니다. */
+static void
+wheel_run (void) {
+	ASSERT (intr_get_level () == INTR_OFF);
+
+	while (wheel_clock <= ticks) {
+		int slot = wheel_clock & WHEEL_MASK;
+
+		/* 레벨 0이 한 바퀴 돌았으면 상위 레벨에서 타이머를 내려받습니다. */
+		if (slot == 0)
+			for (int level = 1; level < WHEEL_LEVELS; level++)
+				if (wheel_cascade (level) != 0)
+					break;
+
+		/* 콜백이 다른 타이머를 취소하거나 새 타이머를 등록할 수 있으므로
+		   슬롯을 통째로 떼어낸 뒤 하나씩 꺼내면서 실행합니다.
+		   그렇지 않으면 64틱 뒤에 만료될 타이머가 지금 비우고 있는
+		   슬롯에 들어와 바로 실행될 수 있습니다. */
+		struct list *bucket = &wheel[0][slot];
+		struct list expired;
+		list_init (&expired);
+		list_splice (list_end (&expired), list_begin (bucket), list_end (bucket));
+		wheel_clock++;
+		while (!list_empty (&expired)) {
+			struct timer *t = list_entry (list_pop_front (&expired), struct timer, elem);
+			t->pending = false;
+			t->func (t->aux);
+		}
+	}
+}
+
 /* LOOPS 반복이 하나 이상의 타이머 틱보다 오래 기다리면 true를 반환하고,
    그렇지 않으면 false를 반환합니다. */
 static bool
@@ -6,6 +6,10 @@
 #include "filesys/filesys.h"
 #include "filesys/free-map.h"
 #include "threads/malloc.h"
+#include "threads/slab.h"
+#ifdef VM
+#include "vm/vm.h"
+#endif
 
 /* Identifies an inode. */
 #define INODE_MAGIC 0x494e4f44
@@ -53,10 +57,14 @@ byte_to_sector (const struct inode *inode, off_t pos) {
  * returns the same `struct inode'. */
 static struct list open_inodes;
 
+/* Cache of in-memory inodes. */
+static struct kmem_cache inode_cache;
+
 /* Initializes the inode module. */
 void
 inode_init (void) {
 	list_init (&open_inodes);
+	kmem_cache_init (&inode_cache, "inode", sizeof (struct inode), NULL);
 }
 
 /* Initializes an inode with LENGTH bytes of data and
@@ -115,7 +123,7 @@ inode_open (disk_sector_t sector) {
 	}
 
 	/* Allocate memory. */
-	inode = malloc (sizeof *inode);
+	inode = kmem_cache_alloc (&inode_cache);
 	if (inode == NULL)
 		return NULL;
 
@@ -159,12 +167,15 @@ inode_close (struct inode *inode) {
 
 		/* Deallocate blocks if removed. */
 		if (inode->removed) {
+#ifdef VM
+			vm_text_invalidate (inode->sector);
+#endif
 			free_map_release (inode->sector, 1);
 			free_map_release (inode->data.start,
 					bytes_to_sectors (inode->data.length)); 
 		}
 
-		free (inode); 
+		kmem_cache_free (&inode_cache, inode);
 	}
 }
 
@@ -239,6 +250,11 @@ inode_write_at (struct inode *inode, const void *buffer_, off_t size,
 
 	if (inode->deny_write_cnt)
 		return 0;
+#ifdef VM
+	/* 캐시된 실행 파일 페이지가 옛 내용을 갖고 있지 않게 합니다. */
+	if (size > 0)
+		vm_text_invalidate (inode->sector);
+#endif
 
 	while (size > 0) {
 		/* Sector to write, starting byte offset within sector. */
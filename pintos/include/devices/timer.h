@@ -1,23 +1,51 @@
 #ifndef DEVICES_TIMER_H
 #define DEVICES_TIMER_H
 
+#include <list.h>
 #include <round.h>
+#include <stdbool.h>
 #include <stdint.h>
 
 /* Number of timer interrupts per second. */
 #define TIMER_FREQ 100
 
+/* 커널 타이머 콜백. 타이머 인터럽트 컨텍스트에서 호출되므로
+   슬립하면 안 됩니다. */
+typedef void timer_func (void *aux);
+
+/* 커널 타이머.
+   timer_setup()으로 초기화한 뒤 timer_add()로 등록하면
+   EXPIRES 틱에 FUNC(AUX)가 호출됩니다. 구조체의 메모리는
+   호출자가 소유하며, 만료되거나 취소될 때까지 유지되어야 합니다. */
+struct timer {
+	int64_t expires;            /* 만료 시각 (틱) */
+	timer_func *func;           /* 만료 시 호출할 함수 */
+	void *aux;                  /* FUNC에 넘길 인자 */
+	struct list_elem elem;      /* 타이밍 휠 슬롯의 리스트 요소 */
+	bool pending;               /* 휠에 등록되어 있으면 true */
+};
+
 void timer_init (void);
 void timer_calibrate (void);
 
 int64_t timer_ticks (void);
 int64_t timer_elapsed (int64_t);
 
+void timer_setup (struct timer *, timer_func *, void *aux);
+void timer_add (struct timer *, int64_t expires);
+bool timer_cancel (struct timer *);
+bool timer_pending (const struct timer *);
+
 void timer_sleep (int64_t ticks);
 void timer_msleep (int64_t milliseconds);
 void timer_usleep (int64_t microseconds);
 void timer_nsleep (int64_t nanoseconds);
 
+extern bool timer_tickless;
+void timer_idle_enter (void);
+void timer_idle_exit (bool timer_irq);
+
 void timer_print_stats (void);
+int64_t timer_skipped_ticks (void);
 
 #endif /* devices/timer.h */
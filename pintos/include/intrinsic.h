@@ -119,6 +119,24 @@ static __inline uint64_t rcr2(void) {
 	return val;
 }
 
+/* VAL에서 가장 높은 위치의 set 비트 번호를 반환합니다.
+   VAL이 0이면 결과는 정의되지 않습니다. [IA32-v2a] "BSR" 참조. */
+__attribute__((always_inline))
+static __inline uint64_t bsr(uint64_t val) {
+	uint64_t idx;
+	__asm __volatile("bsrq %1,%0" : "=r" (idx) : "rm" (val) : "cc");
+	return idx;
+}
+
+/* 타임스탬프 카운터(TSC)를 읽습니다. 타이머 틱보다 훨씬 짧은 구간을
+   잴 때 씁니다. [IA32-v2b] "RDTSC" 참조. */
+__attribute__((always_inline))
+static __inline uint64_t rdtsc(void) {
+	uint32_t lo, hi;
+	__asm __volatile("rdtsc" : "=a" (lo), "=d" (hi));
+	return ((uint64_t) hi << 32) | lo;
+}
+
 __attribute__((always_inline))
 static __inline void write_msr(uint32_t ecx, uint64_t val) {
 	uint32_t edx, eax;
@@ -0,0 +1,58 @@
+#ifndef __LIB_KERNEL_AVL_H
+#define __LIB_KERNEL_AVL_H
+
+/* 침입형(intrusive) AVL 트리.
+ *
+ * list, heap과 마찬가지로 동적 메모리 할당이 필요하지 않습니다. 트리에
+ * 들어갈 구조체는 struct avl_elem 멤버를 내장해야 하고, avl_entry 매크로로
+ * avl_elem에서 바깥 구조체를 얻습니다.
+ *
+ * 두 요소 A, B에 대해 less (A, B)와 less (B, A)가 모두 false이면 같은
+ * 요소로 봅니다. 그래서 서로 겹치지 않는 구간을 넣는 트리에서 "A의 끝이
+ * B의 시작 이하"를 less로 쓰면, 같다는 것이 곧 겹친다는 뜻이 되어
+ * avl_find로 어떤 주소나 구간과 겹치는 요소를 찾을 수 있습니다.
+ *
+ * avl_insert, avl_remove, avl_find는 O(log n)이고, avl_first와
+ * avl_next로 작은 것부터 차례로 순회할 수 있습니다. */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* 트리 요소. */
+struct avl_elem {
+	struct avl_elem *parent;    /* 부모, 루트면 NULL. */
+	struct avl_elem *left;      /* 더 작은 요소들의 서브트리. */
+	struct avl_elem *right;     /* 더 큰 요소들의 서브트리. */
+	int height;                 /* 이 요소를 루트로 하는 서브트리의 높이. */
+};
+
+/* A가 B보다 작으면 true를 반환합니다. */
+typedef bool avl_less_func (const struct avl_elem *a,
+                            const struct avl_elem *b,
+                            void *aux);
+
+/* 트리. */
+struct avl {
+	struct avl_elem *root;      /* 루트, 비어있으면 NULL. */
+	size_t size;                /* 요소 수. */
+	avl_less_func *less;        /* 비교 함수. */
+	void *aux;                  /* LESS에 넘길 보조 데이터. */
+};
+
+/* 트리 요소 AVL_ELEM을 감싸고 있는 구조체의 포인터로 바꿉니다.
+   list_entry와 같은 방식으로 사용합니다. */
+#define avl_entry(AVL_ELEM, STRUCT, MEMBER)             \
+	((STRUCT *) ((uint8_t *) &(AVL_ELEM)->parent    \
+		- offsetof (STRUCT, MEMBER.parent)))
+
+void avl_init (struct avl *, avl_less_func *, void *aux);
+struct avl_elem *avl_insert (struct avl *, struct avl_elem *);
+void avl_remove (struct avl *, struct avl_elem *);
+struct avl_elem *avl_find (struct avl *, const struct avl_elem *key);
+struct avl_elem *avl_first (struct avl *);
+struct avl_elem *avl_next (struct avl_elem *);
+size_t avl_size (struct avl *);
+bool avl_empty (struct avl *);
+
+#endif /* lib/kernel/avl.h */
@@ -0,0 +1,51 @@
+#ifndef __LIB_KERNEL_HEAP_H
+#define __LIB_KERNEL_HEAP_H
+
+/* 침입형(intrusive) 최대 페어링 힙.
+ *
+ * list와 마찬가지로 동적 메모리 할당이 필요하지 않습니다. 힙에 들어갈
+ * 구조체는 struct heap_elem 멤버를 내장해야 하고, heap_entry 매크로로
+ * heap_elem에서 바깥 구조체를 얻습니다. 인터럽트가 꺼진 상태에서도
+ * 안전하게 쓸 수 있어야 하므로 배열 기반 힙 대신 페어링 힙을 씁니다.
+ *
+ * heap_push와 heap_top은 O(1), heap_pop과 heap_remove는 분할 상환
+ * O(log n)입니다. 힙에 들어있는 요소의 키를 바꾸려면 heap_remove로
+ * 꺼낸 뒤 키를 바꾸고 heap_push로 다시 넣어야 합니다. */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/* 힙 요소. */
+struct heap_elem {
+	struct heap_elem *child;    /* 가장 왼쪽 자식. */
+	struct heap_elem *next;     /* 오른쪽 형제. */
+	struct heap_elem *prev;     /* 왼쪽 형제, 가장 왼쪽 자식이면 부모. */
+};
+
+/* A가 B보다 작으면 true를 반환합니다. */
+typedef bool heap_less_func (const struct heap_elem *a,
+                             const struct heap_elem *b,
+                             void *aux);
+
+/* 힙. */
+struct heap {
+	struct heap_elem *root;     /* 가장 큰 요소, 비어있으면 NULL. */
+	heap_less_func *less;       /* 비교 함수. */
+	void *aux;                  /* LESS에 넘길 보조 데이터. */
+};
+
+/* 힙 요소 HEAP_ELEM을 감싸고 있는 구조체의 포인터로 바꿉니다.
+   list_entry와 같은 방식으로 사용합니다. */
+#define heap_entry(HEAP_ELEM, STRUCT, MEMBER)           \
+	((STRUCT *) ((uint8_t *) &(HEAP_ELEM)->next     \
+		- offsetof (STRUCT, MEMBER.next)))
+
+void heap_init (struct heap *, heap_less_func *, void *aux);
+void heap_push (struct heap *, struct heap_elem *);
+struct heap_elem *heap_pop (struct heap *);
+void heap_remove (struct heap *, struct heap_elem *);
+struct heap_elem *heap_top (struct heap *);
+bool heap_empty (struct heap *);
+
+#endif /* lib/kernel/heap.h */
@@ -0,0 +1,17 @@
+#ifndef __LIB_MMAN_H
+#define __LIB_MMAN_H
+
+/* mmap()과 madvise()의 인자. 커널과 사용자 프로그램이 함께 씁니다. */
+
+/* mmap()의 WRITABLE 인자에 함께 줄 수 있는 플래그.
+ * mmap()이 돌아오기 전에 매핑한 페이지를 모두 읽어 옵니다. */
+#define MAP_POPULATE 0x2
+
+/* madvise()의 ADVICE 인자. */
+#define MADV_NORMAL 0           /* 기본 동작으로 되돌림 */
+#define MADV_RANDOM 1           /* 무작위 접근: 주변 페이지를 미리 읽지 않음 */
+#define MADV_SEQUENTIAL 2       /* 순차 접근: 크게 미리 읽고 지나간 페이지를 버림 */
+#define MADV_WILLNEED 3         /* 곧 쓸 페이지: 백그라운드에서 미리 읽음 */
+#define MADV_DONTNEED 4         /* 당분간 쓰지 않을 페이지: 프레임을 바로 놓음 */
+
+#endif /* lib/mman.h */
@@ -0,0 +1,40 @@
+#ifndef __LIB_PFSTAT_H
+#define __LIB_PFSTAT_H
+
+#include <stdint.h>
+
+/* 페이지 폴트 지연 시간 통계. pfstat() 시스템 콜로 읽습니다. 커널과 사용자
+ * 프로그램이 함께 씁니다. 시간은 page_fault() 진입부터 복귀까지의 TSC
+ * 사이클입니다. */
+
+/* 폴트의 종류. */
+enum fault_class {
+	FAULT_UNINIT_ANON,      /* 처음 접근한 익명 페이지 (BSS, 실행 파일 데이터) */
+	FAULT_UNINIT_FILE,      /* 처음 접근한 mmap 페이지 */
+	FAULT_SWAP_IN,          /* 스왑 아웃된 익명 페이지 */
+	FAULT_FILE_REREAD,      /* 축출된 뒤 파일에서 다시 읽는 페이지 */
+	FAULT_STACK,            /* 스택 확장 */
+	FAULT_COW,              /* 공유 프레임이나 제로 페이지에 대한 쓰기 */
+	FAULT_INVALID,          /* 처리하지 못한 폴트 */
+	FAULT_CLASS_CNT
+};
+
+/* 히스토그램 버킷 수. 버킷 i에는 [2^i, 2^(i+1)) 사이클이 걸린 폴트가
+ * 들어가고, 마지막 버킷에는 그보다 오래 걸린 폴트도 모두 들어갑니다. */
+#define FAULT_HIST_BUCKETS 32
+
+/* 한 종류의 폴트 통계. */
+struct fault_hist {
+	uint64_t count;                         /* 폴트 수 */
+	uint64_t cycles;                        /* 걸린 사이클 합 */
+	uint64_t max;                           /* 가장 오래 걸린 폴트 */
+	uint64_t buckets[FAULT_HIST_BUCKETS];   /* log2 히스토그램 */
+};
+
+struct pfstat {
+	struct fault_hist sys[FAULT_CLASS_CNT]; /* 부팅 뒤 시스템 전체 */
+	uint64_t proc_count[FAULT_CLASS_CNT];   /* 호출한 프로세스의 폴트 수 */
+	uint64_t proc_cycles[FAULT_CLASS_CNT];  /* 호출한 프로세스의 사이클 합 */
+};
+
+#endif /* lib/pfstat.h */
@@ -36,6 +36,10 @@ enum {
 
 	SYS_MOUNT,
 	SYS_UMOUNT,
+
+	/* 가상 메모리 확장 */
+	SYS_MADVISE,                /* 메모리 사용 방식 알림 */
+	SYS_PFSTAT,                 /* 페이지 폴트 통계 읽기 */
 };
 
 #endif /* lib/syscall-nr.h */
@@ -4,6 +4,8 @@
 #include <stdbool.h>
 #include <debug.h>
 #include <stddef.h>
+#include <mman.h>
+#include <pfstat.h>
 
 /* 프로세스 식별자 */
 typedef int pid_t;
@@ -41,6 +43,8 @@ int dup2(int oldfd, int newfd);
 /* 프로젝트 3 그리고 선택적으로 프로젝트 4 */
 void *mmap (void *addr, size_t length, int writable, int fd, off_t offset);
 void munmap (void *addr);
+int madvise (void *addr, size_t length, int advice);
+int pfstat (struct pfstat *buf);
 
 /* Project 4 only. */
 bool chdir (const char *dir);
@@ -0,0 +1,76 @@
+#ifndef THREADS_FIXED_POINT_H
+#define THREADS_FIXED_POINT_H
+
+#include <stdint.h>
+
+/* 17.14 고정소수점 수.
+ *
+ * 커널은 부동소수점 연산을 쓸 수 없으므로(-msoft-float, -mno-sse),
+ * mlfqs 스케줄러의 recent_cpu와 load_avg는 정수의 하위 14비트를
+ * 소수부로 사용하는 고정소수점으로 계산합니다.
+ * X, Y는 고정소수점 수, N은 정수입니다. */
+typedef int fixed_t;
+
+#define FP_SHIFT 14
+#define FP_F (1 << FP_SHIFT)
+
+/* 정수 N을 고정소수점으로 바꿉니다. */
+static inline fixed_t
+fp_from_int (int n) {
+	return n * FP_F;
+}
+
+/* X를 0 방향으로 버림하여 정수로 바꿉니다. */
+static inline int
+fp_to_int (fixed_t x) {
+	return x / FP_F;
+}
+
+/* X를 가장 가까운 정수로 반올림합니다. */
+static inline int
+fp_round (fixed_t x) {
+	return x >= 0 ? (x + FP_F / 2) / FP_F : (x - FP_F / 2) / FP_F;
+}
+
+static inline fixed_t
+fp_add (fixed_t x, fixed_t y) {
+	return x + y;
+}
+
+static inline fixed_t
+fp_sub (fixed_t x, fixed_t y) {
+	return x - y;
+}
+
+static inline fixed_t
+fp_add_int (fixed_t x, int n) {
+	return x + n * FP_F;
+}
+
+static inline fixed_t
+fp_sub_int (fixed_t x, int n) {
+	return x - n * FP_F;
+}
+
+/* 곱셈과 나눗셈은 중간값이 32비트를 넘을 수 있으므로 64비트로 계산합니다. */
+static inline fixed_t
+fp_mul (fixed_t x, fixed_t y) {
+	return ((int64_t) x) * y / FP_F;
+}
+
+static inline fixed_t
+fp_mul_int (fixed_t x, int n) {
+	return x * n;
+}
+
+static inline fixed_t
+fp_div (fixed_t x, fixed_t y) {
+	return ((int64_t) x) * FP_F / y;
+}
+
+static inline fixed_t
+fp_div_int (fixed_t x, int n) {
+	return x / n;
+}
+
+#endif /* threads/fixed_point.h */
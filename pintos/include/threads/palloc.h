@@ -14,10 +14,25 @@ enum palloc_flags {
 /* Maximum number of pages to put in user pool. */
 extern size_t user_page_limit;
 
+/* 블록 크기의 종류 수. 가장 큰 블록은 2^(BUDDY_ORDERS - 1) 페이지입니다. */
+#define BUDDY_ORDERS 20
+
+/* 풀 하나의 통계. palloc_get_stats()로 읽습니다. */
+struct palloc_stats {
+	size_t free_pages;                  /* 빈 페이지 수 */
+	size_t free_blocks[BUDDY_ORDERS];   /* order별 빈 블록 수 */
+	size_t zeroed_cnt;                  /* 0으로 채워 둔 예비 페이지 수 */
+	uint64_t zero_hits;                 /* 예비 페이지로 처리한 PAL_ZERO 요청 */
+	uint64_t zero_misses;               /* 직접 memset 한 PAL_ZERO 요청 */
+};
+
 uint64_t palloc_init (void);
 void *palloc_get_page (enum palloc_flags);
 void *palloc_get_multiple (enum palloc_flags, size_t page_cnt);
 void palloc_free_page (void *);
 void palloc_free_multiple (void *, size_t page_cnt);
+void palloc_refill_zeroed (void);
+void palloc_get_stats (enum palloc_flags, struct palloc_stats *);
+void palloc_print_stats (void);
 
 #endif /* threads/palloc.h */
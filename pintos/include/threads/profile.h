@@ -0,0 +1,18 @@
+#ifndef THREADS_PROFILE_H
+#define THREADS_PROFILE_H
+
+#include <stdbool.h>
+#include "threads/interrupt.h"
+
+/* 타이머 기반 샘플링 프로파일러.
+   -profile=N 옵션을 주면 N 틱마다 인터럽트된 위치를 기록하고,
+   종료할 때 utils/pintos-prof 로 해석할 수 있는 이진 형식으로
+   시리얼 포트에 내보냅니다. */
+
+extern int profile_interval;
+
+void profile_start (int interval);
+void profile_sample (struct intr_frame *);
+void profile_dump (void);
+
+#endif /* threads/profile.h */
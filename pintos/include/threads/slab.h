@@ -0,0 +1,56 @@
+#ifndef THREADS_SLAB_H
+#define THREADS_SLAB_H
+
+#include <list.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "threads/synch.h"
+
+/* 같은 크기의 객체를 위한 캐시 할당자.
+
+   malloc()은 요청 크기를 2의 거듭제곱으로 올림하고 매번 descriptor 락을
+   잡습니다. 자주 할당되는 구조체는 크기별로 kmem_cache 를 만들어
+   페이지(slab)를 정확한 크기의 칸으로 나누어 쓰고, magazine 에
+   최근에 해제된 객체를 쌓아 두어 대부분의 할당과 해제가 락 없이
+   끝나도록 합니다. */
+
+/* magazine 하나에 쌓아 둘 객체 수. */
+#define KMEM_MAG_SIZE 16
+
+/* 최근에 해제된 객체를 쌓아 두는 스택.
+   인터럽트를 끈 상태에서만 접근하므로 락이 필요 없습니다. */
+struct kmem_magazine {
+	int cnt;
+	void *objs[KMEM_MAG_SIZE];
+};
+
+/* 객체 캐시. */
+struct kmem_cache {
+	const char *name;                   /* 이름 (통계용) */
+	size_t obj_size;                    /* 8바이트로 정렬한 객체 크기 */
+	size_t objs_per_slab;               /* slab 하나에 들어가는 객체 수 */
+	size_t obj_ofs;                     /* slab 안에서 첫 객체의 위치 */
+	void (*ctor) (void *);              /* 생성자, 없으면 NULL */
+
+	struct lock lock;                   /* slab 목록 보호 */
+	struct list partial;                /* 빈 칸이 있는 slab 들 */
+	size_t partial_cnt;                 /* partial 목록의 slab 수 */
+	struct list full;                   /* 꽉 찬 slab 들 */
+	struct kmem_magazine mag;           /* 최근에 해제된 객체들 */
+	struct list_elem elem;              /* 캐시 목록의 요소 */
+
+	/* 통계. */
+	uint64_t allocs;                    /* 할당 횟수 */
+	uint64_t frees;                     /* 해제 횟수 */
+	uint64_t mag_hits;                  /* magazine 에서 끝난 할당 횟수 */
+	uint64_t slabs;                     /* 지금 가지고 있는 slab 수 */
+};
+
+void kmem_cache_init (struct kmem_cache *, const char *name, size_t size,
+		void (*ctor) (void *));
+void *kmem_cache_alloc (struct kmem_cache *);
+void *kmem_cache_zalloc (struct kmem_cache *);
+void kmem_cache_free (struct kmem_cache *, void *);
+void kmem_cache_print_stats (void);
+
+#endif /* threads/slab.h */
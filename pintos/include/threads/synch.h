@@ -1,13 +1,33 @@
 #ifndef THREADS_SYNCH_H
 #define THREADS_SYNCH_H
 
+#include <heap.h>
 #include <list.h>
 #include <stdbool.h>
+#include <stdint.h>
+
+#ifdef LOCK_PROFILE
+/* 락 경합 프로파일러의 통계 (LOCK_PROFILE 로 빌드할 때만 존재).
+   시간 단위는 타이머 tick 입니다. */
+struct sync_stat {
+	const char *name;           /* 이름, NULL 이면 보고하지 않음 */
+	struct list_elem elem;      /* sync_stat_list 의 요소 */
+	uint64_t acquires;          /* down / acquire 횟수 */
+	uint64_t contended;         /* 기다려야 했던 횟수 */
+	int64_t wait_total;         /* 기다린 시간의 합 */
+	int64_t wait_max;           /* 가장 오래 기다린 시간 */
+	int64_t hold_total;         /* 락을 보유한 시간의 합 (락만) */
+	int64_t acquired_at;        /* 마지막으로 락을 얻은 시각 (락만) */
+};
+#endif
 
 /* 카운팅 세마포어 */
 struct semaphore {
 	unsigned value;             /* 현재 값 */
 	struct list waiters;        /* 대기 중인 스레드들의 목록 */
+#ifdef LOCK_PROFILE
+	struct sync_stat stat;      /* 경합 통계 */
+#endif
 };
 
 void sema_init (struct semaphore *, unsigned value);
@@ -15,11 +35,17 @@ void sema_down (struct semaphore *);
 bool sema_try_down (struct semaphore *);
 void sema_up (struct semaphore *);
 void sema_self_test (void);
+void sema_set_name (struct semaphore *, const char *name);
 
 /* 락 */
 struct lock {
 	struct thread *holder;      /* 락을 보유한 스레드 (디버깅용) */
 	struct semaphore semaphore; /* 접근을 제어하는 이진 세마포어 */
+
+	/* project 1.3 priority_donation */
+	struct heap donors;         /* 이 락을 기다리는 쓰레드들 (priority 최대 힙) */
+	struct heap_elem held_elem; /* holder 의 held_locks 힙 요소 */
+	int priority;               /* 가장 높은 대기자의 priority, 없으면 PRI_MIN - 1 */
 };
 
 void lock_init (struct lock *);
@@ -27,6 +53,9 @@ void lock_acquire (struct lock *);
 bool lock_try_acquire (struct lock *);
 void lock_release (struct lock *);
 bool lock_held_by_current_thread (const struct lock *);
+void lock_set_name (struct lock *, const char *name);
+bool cmp_lock_priority (const struct heap_elem *, const struct heap_elem *,
+                        void *aux);
 
 /* 조건 변수 */
 struct condition {
@@ -38,6 +67,10 @@ void cond_wait (struct condition *, struct lock *);
 void cond_signal (struct condition *, struct lock *);
 void cond_broadcast (struct condition *, struct lock *);
 
+#ifdef LOCK_PROFILE
+void synch_print_stats (void);
+#endif
+
 /* 최적화 장벽
  *
  * 컴파일러는 최적화 장벽을 넘어서 연산을 재배치하지 않습니다. 
@@ -6,7 +6,9 @@
 #include <stdint.h>
 #include "threads/interrupt.h"
 #include "threads/synch.h"
+#include "threads/fixed_point.h"
 #ifdef VM
+#include <pfstat.h>
 #include "vm/vm.h"
 #endif
 
@@ -35,6 +37,11 @@ typedef int tid_t;
 #define PRI_DEFAULT 31                  /* 기본 우선순위 */
 #define PRI_MAX 63                      /* 최고 우선순위 */
 
+/* mlfqs 의 nice 값 범위 */
+#define NICE_MIN -20                    /* 가장 양보를 덜 하는 값 */
+#define NICE_DEFAULT 0                  /* 기본 nice 값 */
+#define NICE_MAX 20                     /* 가장 양보를 많이 하는 값 */
+
 #define min(a, b) ((a) < (b) ? (a) : (b)) /* min값 찾기 */
 #define max(a, b) ((a) > (b) ? (a) : (b)) /* max값 찾기 */
 
@@ -43,6 +50,10 @@ struct fdt_entry {
 	void *entry;
 };
 
+/* struct fdt_entry 를 할당하는 캐시 (threads/slab.h) */
+struct kmem_cache;
+extern struct kmem_cache fdt_entry_cache;
+
 /* 커널 스레드 또는 사용자 프로세스
  *
  * 각 스레드 구조체는 자체 4KB 페이지에 저장됩니다. 스레드 구조체 자체는 
@@ -103,17 +114,21 @@ struct thread {
 	/* thread.c와 synch.c가 공유 */
 	struct list_elem elem;              /* 리스트 요소 */
     
-    /* project 1.1 alarm wakeup 을 위한 구조체 */
-    int64_t ticks;                       /* wake up time */
-    
     /* project 1.3 priority_donation 을 위한 구조체 */
     int origin_priority;                /* 쓰레드 생성 시 받은 priority */
 
-    struct list donation_list;          /* 나한테 기부한 쓰레드 목록 ( 내 우선순위 보다 큰 값만 )*/
-    struct list_elem donation_elem;     /* 여러 donation list 와 연결될 수 있는 */ 
+    struct heap held_locks;             /* 내가 가진 락들 (lock->priority 최대 힙) */
+    struct heap_elem donor_elem;        /* waiting_lock 의 donors 힙 요소 */
 
     struct lock *waiting_lock;          /* 내가 기다리고 있는 락 */
 
+    /* project 1.4 mlfqs 를 위한 구조체 */
+    int nice;                           /* 다른 쓰레드에게 양보하는 정도 */
+    fixed_t recent_cpu;                 /* 최근에 사용한 CPU 시간 (고정소수점) */
+    struct list_elem all_elem;          /* 모든 쓰레드 목록(all_list)의 요소 */
+    struct list_elem mlfqs_elem;        /* priority 재계산 대기 목록의 요소 */
+    bool mlfqs_dirty;                   /* recent_cpu 가 바뀌어 priority 재계산이 필요한지 */
+
     /* proejct 2 를 위한 구조체 */
     int exit_status;                    /* 프로세스 종료 코드 */
 	bool is_exited;						/* 종료 여부 확인, 부모 프로세스에 전달하는 용도 */
@@ -139,6 +154,11 @@ struct thread {
 	/* 스레드가 소유한 전체 가상 메모리를 위한 테이블 */
 	struct supplemental_page_table spt;
 	struct hash vm;
+	void *user_rsp;                     /* 시스템 콜 진입 시점의 사용자 rsp */
+	enum fault_class fault_class;       /* 처리 중인 페이지 폴트의 종류 */
+	uint64_t fault_cnt[FAULT_CLASS_CNT];    /* 종류별 페이지 폴트 수 */
+	uint64_t fault_cycles[FAULT_CLASS_CNT]; /* 종류별 페이지 폴트 사이클 합 */
+	struct exec_trace *exec_trace;      /* 기록 중인 실행 파일 폴트 기록 */
 #endif
 
 	/* thread.c가 소유 */
@@ -163,14 +183,6 @@ tid_t thread_create (const char *name, int priority, thread_func *, void *);
 void thread_block (void);
 void thread_unblock (struct thread *);
 
-/* project 1.1 alarm 을 위한 커스텀 함수 목록 */
-void thread_sleep(int64_t ticks);
-bool cmp_ticks(const struct list_elem *a, const struct list_elem *b, void * aux );
-void thread_wakeup();
-int64_t get_minimum_tick(void);
-void set_minimum_tick(void);
-/* project 1.1 alarm 을 위한 커스텀 함수 목록 */
-
 struct thread *thread_current (void);
 tid_t thread_tid (void);
 const char *thread_name (void);
@@ -185,6 +197,7 @@ void thread_set_priority (int);
 /* project 1.3 priority 를 위한 커스텀 함수 */
 bool cmp_prioirty(const struct list_elem * a, const struct list_elem * b, void * aux);
 int thread_max_priority(struct thread *t);
+void thread_change_priority(struct thread *t, int priority);
 
 
 int thread_get_nice (void);
@@ -6,7 +6,10 @@
 #define PF_W 0x2    /* 0: 읽기, 1: 쓰기. */
 #define PF_U 0x4    /* 0: 커널, 1: 사용자 프로세스. */
 
+struct pfstat;
+
 void exception_init (void);
 void exception_print_stats (void);
+void exception_pfstat (struct pfstat *);
 
 #endif /* userprog/exception.h */
@@ -2,12 +2,23 @@
 #define VM_ANON_H
 #include "vm/vm.h"
 struct page;
+struct zswap_entry;
 enum vm_type;
 
+/* 스왑 인 때 함께 읽어 들일 이웃 슬롯 창의 크기 (2의 거듭제곱). */
+#define SWAP_READAHEAD 8
+
 struct anon_page {
+	size_t swap_slot;   /* 스왑 아웃된 슬롯 번호. 메모리에 있으면 BITMAP_ERROR */
+	struct zswap_entry *zentry; /* 압축 스왑 캐시의 항목, 없으면 NULL */
 };
 
 void vm_anon_init (void);
 bool anon_initializer (struct page *page, enum vm_type type, void *kva);
+bool anon_swap_write (struct page *page, const void *kva);
+void anon_swap_share (struct page *page, struct page *sharer);
+size_t anon_swap_readahead (struct page *page, struct page *pages[],
+		size_t max);
+void swap_print_stats (void);
 
 #endif
@@ -0,0 +1,20 @@
+#ifndef VM_EXECTRACE_H
+#define VM_EXECTRACE_H
+
+struct file;
+struct page;
+
+/* 실행 파일마다 기록하는 최대 페이지 수. */
+#define EXEC_TRACE_MAX 31
+
+/* 실행 파일마다 기록할 페이지 수. 0이면 쓰지 않습니다.
+ * 커널 옵션 -exec-trace=N으로 정합니다. */
+extern unsigned exec_trace_pages;
+
+void exec_trace_init (void);
+void exec_trace_start (struct file *exe);
+void exec_trace_record (struct page *page);
+void exec_trace_finish (void);
+void exec_trace_print_stats (void);
+
+#endif
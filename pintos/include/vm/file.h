@@ -6,11 +6,16 @@
 struct page;
 enum vm_type;
 
+/* 파일 페이지의 파일 안 위치. 파일은 페이지가 속한 영역(page->vma)의
+ * 파일이며, 영역이 없어질 때 닫습니다. */
 struct file_page {
+	off_t ofs;              /* 파일 안에서 페이지의 시작 위치 */
+	size_t read_bytes;      /* 파일에서 읽을 바이트 수, 나머지는 0으로 채움 */
 };
 
 void vm_file_init (void);
 bool file_backed_initializer (struct page *page, enum vm_type type, void *kva);
+void file_page_writeback (struct page *page);
 void *do_mmap(void *addr, size_t length, int writable,
 		struct file *file, off_t offset);
 void do_munmap (void *va);
@@ -2,8 +2,12 @@
 #define VM_VM_H
 #include <stdbool.h>
 #include "threads/palloc.h"
+#include "threads/synch.h"
+#include "devices/disk.h"
+#include "lib/kernel/avl.h"
 #include "lib/kernel/hash.h"
-
+#include "lib/kernel/list.h"
+#include <debug.h>
 
 enum vm_type {
 	/* page not initialized*/
@@ -26,6 +30,12 @@ enum vm_type {
 	VM_MARKER_END = (1 << 31),
 };
 
+/* 스택 페이지 표시. */
+#define VM_STACK VM_MARKER_0
+
+/* 스택이 자랄 수 있는 최대 크기. */
+#define STACK_LIMIT (1 << 20)
+
 #include "vm/uninit.h"
 #include "vm/anon.h"
 #include "vm/file.h"
@@ -35,6 +45,7 @@ enum vm_type {
 
 struct page_operations;
 struct thread;
+struct vm_area;
 
 #define VM_TYPE(type) ((type) & 7)
 
@@ -50,7 +61,12 @@ struct page {
 	struct frame *frame;   /* Back reference for frame */
 
 	struct hash_elem hash_elem;
-	
+	struct vm_area *vma;   /* 이 페이지가 속한 영역 */
+	struct list_elem vma_elem; /* vma->pages의 원소 */
+	uint64_t *pml4;        /* 이 페이지를 매핑하는 페이지 테이블 */
+	bool writable;         /* 사용자 쓰기 허용 여부 */
+	struct page *next_sharer; /* 같은 프레임을 매핑한 다음 페이지 (rmap) */
+	struct page **pprev_sharer; /* 이 페이지를 가리키는 앞 링크 (rmap) */
 
 	/* Per-type data are binded into the union.
 	 * Each function automatically detects the current union */
@@ -70,6 +86,20 @@ struct page {
 struct frame {
 	void *kva; //커널 가상 주소(Kernel Virtual Address)
 	struct page *page; //이 물리 프레임에 현재 매핑되어 있는 page 구조체에 대한 포인터
+	                   //역매핑(rmap): 이 프레임을 매핑한 모든 페이지가
+	                   //page->next_sharer로 이어진 목록의 첫 페이지
+	unsigned mapcount; //rmap에 있는 페이지 수
+	struct list_elem elem; //프레임 테이블(frame_table)의 원소
+	bool pinned; //적재/축출 중이거나 커널이 사용 중이라 축출하면 안 되는 프레임
+	uint64_t ksm_sum; //KSM 데몬이 지난번에 계산한 내용의 해시
+	struct hash_elem ksm_elem; //ksm_table의 원소
+	bool ksm_listed; //ksm_table에 들어 있는지
+	struct text_file *text; //이 프레임을 캐시한 실행 파일, 없으면 NULL
+	disk_sector_t text_sector; //캐시된 실행 파일의 inode 섹터
+	off_t text_ofs; //캐시된 내용의 파일 오프셋
+	size_t text_len; //캐시된 내용 중 파일에서 읽은 바이트 수
+	struct list_elem text_elem; //text->frames의 원소
+	struct hash_elem text_hash_elem; //text_frames의 원소
 };
 
 /* The function table for page operations.
@@ -96,27 +126,51 @@ struct page_operations {
  * All designs up to you for this. 
  우리는 이 구조체에 대해 특정 설계를 따르도록 강요하지 않습니다. 모든 설계는 당신에게 달려있습니다.
  */
-struct supplemental_page_table {	
-	struct hash spt_hash;
+/* 한 번의 폴트에서 채울 수 있는 최대 페이지 수 (폴트 페이지 포함). */
+#define FAULT_AROUND_MAX 16
+
+/* 파일에서 읽어 오는 영역(mmap 영역이나 실행 파일 세그먼트) 하나의
+ * fault-around 상태. 순차로 폴트가 나면 창을 늘리고, 아니면 줄입니다. */
+struct fault_around {
+	void *next;             /* 순차 접근이라면 다음 폴트가 날 주소 */
+	unsigned window;        /* 다음 폴트에서 채울 페이지 수 */
 };
 
-
-// 주어진 page 구조체의 가상 주소(va)를 기반으로 해시 값을 반환한다.
-unsigned
-page_hash (const struct hash_elem *elem, void *aux UNUSED){
-	const struct page *p = hash_entry(elem, struct page, hash_elem);
-	return hash_bytes (&p->va, sizeof p->va);
+/* 가상 주소 공간의 한 영역 [start, end).
+ * mmap 영역, 실행 파일 세그먼트, 스택이 각각 하나의 영역입니다. 영역은
+ * 만들 때 페이지를 하나도 만들지 않고, 영역 안의 주소에 처음 폴트가 날 때
+ * 그 페이지의 struct page를 만듭니다. FILE이 있으면 start부터 READ_BYTES
+ * 바이트는 FILE의 오프셋 OFS부터 읽어 오고, 나머지는 0으로 채웁니다. */
+struct vm_area {
+	uint8_t *start;         /* 첫 페이지의 주소 */
+	uint8_t *end;           /* 마지막 페이지 바로 다음 주소 */
+	enum vm_type type;      /* 페이지를 만들 때 쓸 타입 (VM_ANON, VM_FILE, 마커) */
+	bool writable;          /* 사용자 쓰기 허용 여부 */
+	vm_initializer *init;   /* 파일 내용이 있는 페이지의 첫 폴트에서 부를 함수 */
+	struct file *file;      /* 따로 연(file_reopen) 파일, 없으면 NULL */
+	off_t ofs;              /* start에 대응하는 파일 오프셋 */
+	size_t read_bytes;      /* start부터 파일에서 읽을 바이트 수 */
+	struct fault_around fa; /* fault-around 상태 */
+	int advice;             /* madvise()로 알린 접근 방식 (MADV_*) */
+	struct list pages;      /* 이 영역에서 만들어진 페이지들 */
+	struct avl_elem elem;   /* supplemental_page_table의 vmas 원소 */
 };
 
+/* spt_hash에는 영역 안에서 한 번이라도 폴트가 나 만들어진 페이지만
+ * 들어 있습니다. 메모리에 있거나, 스왑 아웃되었거나, 제로 페이지를
+ * 매핑한 페이지입니다.
+ * 주인 스레드 말고도 미리 읽기 스레드(vm_prefetcher)가 페이지를 올리므로,
+ * 페이지를 만들거나 없애거나 올리는 쪽은 LOCK을 쥡니다. */
+struct supplemental_page_table {	
+	struct hash spt_hash;   /* 만들어진 페이지들, va로 찾음 */
+	struct avl vmas;        /* 영역들, 주소 순 */
+	struct lock lock;       /* spt_hash, vmas, 각 영역의 pages를 보호 */
+};
 
-// page1의 가상 주소가 page2의 가상 주소보다 작으면 true를 반환한다. => page1이 더 "앞선다"
-bool
-page_less (const struct hash_elem *elem1, const struct hash_elem *elem2, void *aux UNUSED){
-	const struct page *page1 = hash_entry(elem1, struct page, hash_elem);
-	const struct page *page2 = hash_entry(elem2, struct page, hash_elem);
-
-	return page1->va < page2->va;
-}
+extern unsigned vm_fault_around_max;
+extern unsigned vm_clean_watermark;
+extern unsigned vm_ksm_pages;
+extern unsigned vm_ksm_sleep_ms;
 
 
 #include "threads/thread.h"
@@ -130,8 +184,11 @@ struct page *spt_find_page (struct supplemental_page_table *spt,
 		void *va);
 bool spt_insert_page (struct supplemental_page_table *spt, struct page *page);
 void spt_remove_page (struct supplemental_page_table *spt, struct page *page);
+struct vm_area *spt_find_vma (struct supplemental_page_table *spt,
+		void *va);
 
 void vm_init (void);
+void vm_print_stats (void);
 bool vm_try_handle_fault (struct intr_frame *f, void *addr, bool user,
 		bool write, bool not_present);
 
@@ -140,6 +197,16 @@ bool vm_try_handle_fault (struct intr_frame *f, void *addr, bool user,
 bool vm_alloc_page_with_initializer (enum vm_type type, void *upage,
 		bool writable, vm_initializer *init, void *aux);
 void vm_dealloc_page (struct page *page);
+bool vm_alloc_region (void *start, size_t length, enum vm_type type,
+		bool writable, vm_initializer *init, struct file *file, off_t ofs,
+		size_t read_bytes);
+void vm_dealloc_region (struct vm_area *vma);
+void vm_area_page (const struct vm_area *vma, const void *va,
+		off_t *ofs, size_t *read_bytes);
+int vm_madvise (void *addr, size_t length, int advice);
+size_t vm_populate (void *const pages[], size_t cnt);
+size_t vm_populate_range (void *addr, size_t length);
+void vm_text_invalidate (disk_sector_t sector);
 bool vm_claim_page (void *va);
 enum vm_type page_get_type (struct page *page);
 
@@ -0,0 +1,19 @@
+#ifndef VM_ZSWAP_H
+#define VM_ZSWAP_H
+#include <stdbool.h>
+#include <stddef.h>
+
+struct page;
+struct zswap_entry;
+
+/* 압축 스왑 캐시의 크기 (커널 풀 페이지 수). 0이면 쓰지 않습니다.
+ * 커널 옵션 -zswap=N으로 정합니다. */
+extern size_t zswap_pool_pages;
+
+void zswap_init (void);
+bool zswap_store (struct page *page, const void *kva);
+bool zswap_load (struct page *page, void *kva);
+void zswap_invalidate (struct page *page);
+void zswap_print_stats (void);
+
+#endif
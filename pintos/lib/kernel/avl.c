@@ -0,0 +1,236 @@
+#include "avl.h"
+#include "../debug.h"
+
+/* AVL 트리는 모든 노드에서 왼쪽과 오른쪽 서브트리의 높이 차가 1 이하인
+   이진 탐색 트리입니다. 삽입과 삭제 뒤에는 바뀐 지점부터 루트까지
+   올라가며 높이를 갱신하고, 높이 차가 2가 된 노드를 회전으로 바로잡습니다.
+   각 노드가 부모를 가리키므로 재귀 없이 위로 올라가거나 다음 노드로
+   넘어갈 수 있습니다. */
+
+/* E를 루트로 하는 서브트리의 높이. 빈 트리는 0입니다. */
+static int
+height (const struct avl_elem *e) {
+	return e != NULL ? e->height : 0;
+}
+
+/* 자식들의 높이로 E의 높이를 다시 계산합니다. */
+static void
+update_height (struct avl_elem *e) {
+	int l = height (e->left);
+	int r = height (e->right);
+
+	e->height = (l > r ? l : r) + 1;
+}
+
+/* PARENT의 자식 OLD 자리에 NEW를 넣습니다. PARENT가 NULL이면 OLD가
+   루트였던 것입니다. NEW는 NULL일 수 있습니다. */
+static void
+replace_child (struct avl *avl, struct avl_elem *parent,
+               struct avl_elem *old, struct avl_elem *new) {
+	if (parent == NULL)
+		avl->root = new;
+	else if (parent->left == old)
+		parent->left = new;
+	else
+		parent->right = new;
+	if (new != NULL)
+		new->parent = parent;
+}
+
+/* X를 왼쪽으로 회전시켜 X의 오른쪽 자식을 그 자리에 올리고 반환합니다. */
+static struct avl_elem *
+rotate_left (struct avl *avl, struct avl_elem *x) {
+	struct avl_elem *y = x->right;
+
+	x->right = y->left;
+	if (y->left != NULL)
+		y->left->parent = x;
+	replace_child (avl, x->parent, x, y);
+	y->left = x;
+	x->parent = y;
+	update_height (x);
+	update_height (y);
+	return y;
+}
+
+/* X를 오른쪽으로 회전시켜 X의 왼쪽 자식을 그 자리에 올리고 반환합니다. */
+static struct avl_elem *
+rotate_right (struct avl *avl, struct avl_elem *x) {
+	struct avl_elem *y = x->left;
+
+	x->left = y->right;
+	if (y->right != NULL)
+		y->right->parent = x;
+	replace_child (avl, x->parent, x, y);
+	y->right = x;
+	x->parent = y;
+	update_height (x);
+	update_height (y);
+	return y;
+}
+
+/* E부터 루트까지 올라가며 높이를 갱신하고 균형을 맞춥니다. */
+static void
+rebalance (struct avl *avl, struct avl_elem *e) {
+	while (e != NULL) {
+		int balance = height (e->left) - height (e->right);
+
+		if (balance > 1) {
+			if (height (e->left->left) < height (e->left->right))
+				rotate_left (avl, e->left);
+			e = rotate_right (avl, e);
+		} else if (balance < -1) {
+			if (height (e->right->right) < height (e->right->left))
+				rotate_right (avl, e->right);
+			e = rotate_left (avl, e);
+		} else
+			update_height (e);
+		e = e->parent;
+	}
+}
+
+/* AVL을 LESS로 비교하는 빈 트리로 초기화합니다. */
+void
+avl_init (struct avl *avl, avl_less_func *less, void *aux) {
+	ASSERT (avl != NULL);
+	ASSERT (less != NULL);
+
+	avl->root = NULL;
+	avl->size = 0;
+	avl->less = less;
+	avl->aux = aux;
+}
+
+/* ELEM을 AVL에 넣고 NULL을 반환합니다. ELEM과 같은 요소가 이미
+   있으면 넣지 않고 그 요소를 반환합니다. */
+struct avl_elem *
+avl_insert (struct avl *avl, struct avl_elem *elem) {
+	struct avl_elem *parent = NULL;
+	struct avl_elem **link;
+
+	ASSERT (avl != NULL);
+	ASSERT (elem != NULL);
+
+	link = &avl->root;
+	while (*link != NULL) {
+		parent = *link;
+		if (avl->less (elem, parent, avl->aux))
+			link = &parent->left;
+		else if (avl->less (parent, elem, avl->aux))
+			link = &parent->right;
+		else
+			return parent;
+	}
+
+	elem->parent = parent;
+	elem->left = elem->right = NULL;
+	elem->height = 1;
+	*link = elem;
+	avl->size++;
+	rebalance (avl, parent);
+	return NULL;
+}
+
+/* AVL에 들어있는 ELEM을 꺼냅니다. */
+void
+avl_remove (struct avl *avl, struct avl_elem *elem) {
+	struct avl_elem *start;
+
+	ASSERT (avl != NULL);
+	ASSERT (elem != NULL);
+
+	if (elem->left != NULL && elem->right != NULL) {
+		/* 바로 다음 요소 SUCC를 ELEM 자리로 옮깁니다. SUCC는 왼쪽
+		   자식이 없습니다. */
+		struct avl_elem *succ = elem->right;
+
+		while (succ->left != NULL)
+			succ = succ->left;
+		if (succ->parent != elem) {
+			start = succ->parent;
+			replace_child (avl, succ->parent, succ, succ->right);
+			succ->right = elem->right;
+			succ->right->parent = succ;
+		} else
+			start = succ;
+		succ->left = elem->left;
+		succ->left->parent = succ;
+		replace_child (avl, elem->parent, elem, succ);
+	} else {
+		start = elem->parent;
+		replace_child (avl, elem->parent, elem,
+		               elem->left != NULL ? elem->left : elem->right);
+	}
+
+	elem->parent = elem->left = elem->right = NULL;
+	avl->size--;
+	rebalance (avl, start);
+}
+
+/* AVL에서 KEY와 같은 요소를 찾아 반환합니다. 없으면 NULL을 반환합니다. */
+struct avl_elem *
+avl_find (struct avl *avl, const struct avl_elem *key) {
+	struct avl_elem *e;
+
+	ASSERT (avl != NULL);
+	ASSERT (key != NULL);
+
+	e = avl->root;
+	while (e != NULL) {
+		if (avl->less (key, e, avl->aux))
+			e = e->left;
+		else if (avl->less (e, key, avl->aux))
+			e = e->right;
+		else
+			return e;
+	}
+	return NULL;
+}
+
+/* AVL에서 가장 작은 요소를 반환합니다. 비어있으면 NULL을 반환합니다. */
+struct avl_elem *
+avl_first (struct avl *avl) {
+	struct avl_elem *e;
+
+	ASSERT (avl != NULL);
+
+	e = avl->root;
+	if (e != NULL)
+		while (e->left != NULL)
+			e = e->left;
+	return e;
+}
+
+/* ELEM 바로 다음으로 큰 요소를 반환합니다. ELEM이 가장 크면 NULL을
+   반환합니다. 순회 도중 ELEM을 꺼내려면 먼저 다음 요소를 구해 두어야
+   합니다. */
+struct avl_elem *
+avl_next (struct avl_elem *elem) {
+	ASSERT (elem != NULL);
+
+	if (elem->right != NULL) {
+		elem = elem->right;
+		while (elem->left != NULL)
+			elem = elem->left;
+		return elem;
+	}
+	while (elem->parent != NULL && elem->parent->right == elem)
+		elem = elem->parent;
+	return elem->parent;
+}
+
+/* AVL의 요소 수를 반환합니다. */
+size_t
+avl_size (struct avl *avl) {
+	ASSERT (avl != NULL);
+
+	return avl->size;
+}
+
+/* AVL이 비어있으면 true를 반환합니다. */
+bool
+avl_empty (struct avl *avl) {
+	ASSERT (avl != NULL);
+
+	return avl->root == NULL;
+}
@@ -0,0 +1,152 @@
+#include "heap.h"
+#include "../debug.h"
+
+/* 페어링 힙은 각 노드가 자식들을 형제 리스트로 가지는 다진 트리입니다.
+   부모는 항상 모든 자식보다 크거나 같습니다.
+
+   각 노드의 prev는 왼쪽 형제를 가리키고, 가장 왼쪽 자식이면 부모를
+   가리킵니다. 덕분에 임의의 노드를 O(1)에 트리에서 떼어낼 수 있습니다.
+   루트의 prev와 next는 NULL입니다. */
+
+/* 두 힙 A와 B를 합쳐 새 루트를 반환합니다. A와 B는 루트여야 합니다. */
+static struct heap_elem *
+meld (struct heap *heap, struct heap_elem *a, struct heap_elem *b) {
+	if (a == NULL)
+		return b;
+	if (b == NULL)
+		return a;
+	if (heap->less (a, b, heap->aux)) {
+		struct heap_elem *tmp = a;
+		a = b;
+		b = tmp;
+	}
+
+	/* B를 A의 가장 왼쪽 자식으로 붙입니다. */
+	b->prev = a;
+	b->next = a->child;
+	if (a->child != NULL)
+		a->child->prev = b;
+	a->child = b;
+	return a;
+}
+
+/* FIRST부터 시작하는 형제 리스트를 하나의 힙으로 합쳐 루트를
+   반환합니다. 왼쪽에서 오른쪽으로 두 개씩 짝지어 합친 뒤,
+   오른쪽에서 왼쪽으로 누적하여 합치는 two-pass 방식입니다. */
+static struct heap_elem *
+merge_pairs (struct heap *heap, struct heap_elem *first) {
+	struct heap_elem *pairs = NULL;
+	struct heap_elem *root = NULL;
+
+	/* 1단계: 짝지어 합친 결과를 next로 역순 연결합니다. */
+	while (first != NULL) {
+		struct heap_elem *a = first;
+		struct heap_elem *b = a->next;
+		struct heap_elem *m;
+
+		if (b != NULL) {
+			first = b->next;
+			a->next = a->prev = NULL;
+			b->next = b->prev = NULL;
+			m = meld (heap, a, b);
+		} else {
+			first = NULL;
+			a->next = a->prev = NULL;
+			m = a;
+		}
+		m->next = pairs;
+		pairs = m;
+	}
+
+	/* 2단계: 마지막 짝부터 차례로 합칩니다. */
+	while (pairs != NULL) {
+		struct heap_elem *next = pairs->next;
+		pairs->next = NULL;
+		root = meld (heap, root, pairs);
+		pairs = next;
+	}
+	if (root != NULL)
+		root->prev = NULL;
+	return root;
+}
+
+/* HEAP을 LESS로 비교하는 빈 최대 힙으로 초기화합니다. */
+void
+heap_init (struct heap *heap, heap_less_func *less, void *aux) {
+	ASSERT (heap != NULL);
+	ASSERT (less != NULL);
+
+	heap->root = NULL;
+	heap->less = less;
+	heap->aux = aux;
+}
+
+/* ELEM을 HEAP에 넣습니다. */
+void
+heap_push (struct heap *heap, struct heap_elem *elem) {
+	ASSERT (heap != NULL);
+	ASSERT (elem != NULL);
+
+	elem->child = elem->next = elem->prev = NULL;
+	heap->root = meld (heap, heap->root, elem);
+	heap->root->prev = NULL;
+}
+
+/* HEAP에서 가장 큰 요소를 꺼내 반환합니다. HEAP이 비어있으면
+   동작은 정의되지 않습니다. */
+struct heap_elem *
+heap_pop (struct heap *heap) {
+	struct heap_elem *top;
+
+	ASSERT (!heap_empty (heap));
+
+	top = heap->root;
+	heap->root = merge_pairs (heap, top->child);
+	top->child = NULL;
+	return top;
+}
+
+/* HEAP에 들어있는 ELEM을 꺼냅니다. */
+void
+heap_remove (struct heap *heap, struct heap_elem *elem) {
+	struct heap_elem *sub;
+
+	ASSERT (heap != NULL);
+	ASSERT (elem != NULL);
+
+	if (elem == heap->root) {
+		heap_pop (heap);
+		return;
+	}
+
+	/* ELEM을 부모 또는 왼쪽 형제에게서 떼어냅니다. */
+	ASSERT (elem->prev != NULL);
+	if (elem->prev->child == elem)
+		elem->prev->child = elem->next;
+	else
+		elem->prev->next = elem->next;
+	if (elem->next != NULL)
+		elem->next->prev = elem->prev;
+
+	/* ELEM의 자식들을 합쳐 다시 루트와 합칩니다. */
+	sub = merge_pairs (heap, elem->child);
+	elem->child = elem->next = elem->prev = NULL;
+	heap->root = meld (heap, heap->root, sub);
+	heap->root->prev = NULL;
+}
+
+/* HEAP에서 가장 큰 요소를 반환합니다. 비어있으면 NULL을 반환합니다. */
+struct heap_elem *
+heap_top (struct heap *heap) {
+	ASSERT (heap != NULL);
+
+	return heap->root;
+}
+
+/* HEAP이 비어있으면 true를 반환합니다. */
+bool
+heap_empty (struct heap *heap) {
+	ASSERT (heap != NULL);
+
+	return heap->root == NULL;
+}
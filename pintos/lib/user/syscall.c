@@ -155,6 +155,16 @@ munmap (void *addr) {
 	syscall1 (SYS_MUNMAP, addr);
 }
 
+int
+madvise (void *addr, size_t length, int advice) {
+	return syscall3 (SYS_MADVISE, addr, length, advice);
+}
+
+int
+pfstat (struct pfstat *buf) {
+	return syscall1 (SYS_PFSTAT, buf);
+}
+
 bool
 chdir (const char *dir) {
 	return syscall1 (SYS_CHDIR, dir);
@@ -0,0 +1,88 @@
+/* Runs sleepers of different durations with the periodic timer tick
+   stopped while idle.  Each sleeper waits for absolute deadlines, most
+   of them longer than one one-shot PIT period, and records how far
+   from its deadline it woke up.  No wakeup may come early, and none
+   may come more than one tick late. */
+
+#include <stdio.h>
+#include "tests/threads/tests.h"
+#include "threads/init.h"
+#include "threads/synch.h"
+#include "threads/thread.h"
+#include "devices/timer.h"
+
+#define THREAD_CNT 4
+#define ITERATIONS 3
+
+/* Ticks each sleeper waits between its deadlines. */
+static const int durations[THREAD_CNT] = {3, 7, 13, 23};
+
+/* Information about an individual sleeper. */
+struct tickless_sleeper
+  {
+    int64_t start;              /* Time the deadlines count from. */
+    int duration;               /* Ticks between deadlines. */
+    int64_t early;              /* Most ticks woken before a deadline. */
+    int64_t late;               /* Most ticks woken after a deadline. */
+    struct semaphore done;      /* Upped when the sleeper finishes. */
+  };
+
+static void
+sleeper (void *s_)
+{
+  struct tickless_sleeper *s = s_;
+  int i;
+
+  for (i = 1; i <= ITERATIONS; i++)
+    {
+      int64_t deadline = s->start + i * s->duration;
+      int64_t woke;
+
+      timer_sleep (deadline - timer_ticks ());
+      woke = timer_ticks ();
+      if (deadline - woke > s->early)
+        s->early = deadline - woke;
+      if (woke - deadline > s->late)
+        s->late = woke - deadline;
+    }
+  sema_up (&s->done);
+}
+
+void
+test_alarm_tickless (void)
+{
+  struct tickless_sleeper sleepers[THREAD_CNT];
+  int64_t start;
+  int i;
+
+  ASSERT (timer_tickless);
+
+  start = timer_ticks () + 10;
+  for (i = 0; i < THREAD_CNT; i++)
+    {
+      char name[16];
+
+      sleepers[i].start = start;
+      sleepers[i].duration = durations[i];
+      sleepers[i].early = sleepers[i].late = 0;
+      sema_init (&sleepers[i].done, 0);
+      snprintf (name, sizeof name, "sleeper %d", i);
+      thread_create (name, PRI_DEFAULT, sleeper, &sleepers[i]);
+    }
+  for (i = 0; i < THREAD_CNT; i++)
+    sema_down (&sleepers[i].done);
+
+  /* Print only after every sleeper is done: console output raises
+     interrupts that would end tickless sleeps early. */
+  for (i = 0; i < THREAD_CNT; i++)
+    {
+      if (sleepers[i].early > 0)
+        fail ("sleeper %d woke %lld ticks early", i,
+              (long long) sleepers[i].early);
+      if (sleepers[i].late > 1)
+        fail ("sleeper %d woke %lld ticks late", i,
+              (long long) sleepers[i].late);
+      msg ("sleeper %d woke on its %d deadlines", i, ITERATIONS);
+    }
+  pass ();
+}
@@ -0,0 +1,22 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(alarm-tickless) begin
+(alarm-tickless) sleeper 0 woke on its 3 deadlines
+(alarm-tickless) sleeper 1 woke on its 3 deadlines
+(alarm-tickless) sleeper 2 woke on its 3 deadlines
+(alarm-tickless) sleeper 3 woke on its 3 deadlines
+(alarm-tickless) PASS
+(alarm-tickless) end
+EOF
+
+our ($test);
+my (@output) = read_text_file ("$test.output");
+my ($stats) = grep (/^Thread: \d+ idle ticks skipped/, @output);
+fail "missing skipped ticks statistics: tickless idle is off\n"
+  if !defined $stats;
+my ($skipped) = $stats =~ /^Thread: (\d+) idle ticks skipped/;
+fail "no idle ticks were skipped\n" if !$skipped;
+pass;
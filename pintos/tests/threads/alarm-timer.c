@@ -0,0 +1,99 @@
+/* Checks the kernel timer API.  Timers registered with
+   timer_add() must fire on their expiration tick, in expiration
+   order, including timers far enough away to start out in an
+   upper level of the timing wheel.  A timer cancelled with
+   timer_cancel() must never fire, and a callback may re-arm its
+   own timer. */
+
+#include <stdio.h>
+#include "tests/threads/tests.h"
+#include "threads/interrupt.h"
+#include "threads/synch.h"
+#include "threads/thread.h"
+#include "devices/timer.h"
+
+#define TIMER_CNT 5
+#define FIRE_CNT 6
+
+/* Test timers, in the order they are registered. */
+static const struct
+  {
+    const char *name;
+    int64_t delta;
+  }
+timer_info[TIMER_CNT] =
+  {
+    {"far", 300},
+    {"near", 1},
+    {"cancelled", 3},
+    {"periodic", 5},
+    {"cascade", 70},
+  };
+
+static struct timer timers[TIMER_CNT];
+static int64_t start_tick;
+
+/* Record of each callback, written from interrupt context. */
+static struct
+  {
+    int timer;
+    int64_t tick;
+  }
+fired[FIRE_CNT];
+static int fire_cnt;
+static int periodic_left;
+static struct semaphore done;
+
+static timer_func record_fire;
+
+void
+test_alarm_timer (void) 
+{
+  enum intr_level old_level;
+  int i;
+
+  sema_init (&done, 0);
+  fire_cnt = 0;
+  periodic_left = 2;
+
+  old_level = intr_disable ();
+  start_tick = timer_ticks ();
+  for (i = 0; i < TIMER_CNT; i++)
+    {
+      timer_setup (&timers[i], record_fire, (void *) (intptr_t) i);
+      timer_add (&timers[i], start_tick + timer_info[i].delta);
+    }
+  if (!timer_cancel (&timers[2]))
+    fail ("timer_cancel() of a pending timer returned false");
+  intr_set_level (old_level);
+
+  for (i = 0; i < FIRE_CNT; i++)
+    sema_down (&done);
+
+  if (timer_cancel (&timers[2]))
+    fail ("timer_cancel() of a cancelled timer returned true");
+
+  for (i = 0; i < fire_cnt; i++)
+    msg ("timer \"%s\" fired %lld ticks after start",
+         timer_info[fired[i].timer].name, fired[i].tick - start_tick);
+  pass ();
+}
+
+static void
+record_fire (void *aux) 
+{
+  int idx = (intptr_t) aux;
+
+  if (fire_cnt < FIRE_CNT)
+    {
+      fired[fire_cnt].timer = idx;
+      fired[fire_cnt].tick = timer_ticks ();
+      fire_cnt++;
+    }
+
+  /* Re-arm the periodic timer from inside its own callback. */
+  if (idx == 3 && periodic_left-- > 0)
+    timer_add (&timers[idx], timers[idx].expires + timer_info[idx].delta);
+
+  sema_up (&done);
+}
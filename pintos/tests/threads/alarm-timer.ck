@@ -0,0 +1,16 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(alarm-timer) begin
+(alarm-timer) timer "near" fired 1 ticks after start
+(alarm-timer) timer "periodic" fired 5 ticks after start
+(alarm-timer) timer "periodic" fired 10 ticks after start
+(alarm-timer) timer "periodic" fired 15 ticks after start
+(alarm-timer) timer "cascade" fired 70 ticks after start
+(alarm-timer) timer "far" fired 300 ticks after start
+(alarm-timer) PASS
+(alarm-timer) end
+EOF
+pass;
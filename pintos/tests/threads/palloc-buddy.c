@@ -0,0 +1,100 @@
+/* Checks the buddy page allocator.  A large block is freed in
+   scattered pieces, then blocks of mixed sizes are allocated and
+   freed out of order.  After each round the kernel pool must have
+   coalesced back to exactly the free lists it started with, so the
+   same large block is handed out again. */
+
+#include <stdio.h>
+#include <string.h>
+#include "tests/threads/tests.h"
+#include "threads/palloc.h"
+#include "threads/vaddr.h"
+
+#define BIG_PAGES 256
+#define BLOCK_CNT 40
+
+/* Sizes of the mixed blocks, in pages, used in turn. */
+static const size_t block_sizes[] = {1, 2, 3, 5, 8, 13, 21, 34, 64, 4};
+#define SIZE_CNT (sizeof block_sizes / sizeof *block_sizes)
+
+/* Pieces of the large block, freed in this order. */
+static const struct
+  {
+    size_t ofs;
+    size_t cnt;
+  }
+pieces[] =
+  {
+    {0, 1}, {128, 128}, {5, 2}, {1, 4}, {64, 32}, {7, 57}, {96, 32},
+  };
+#define PIECE_CNT (sizeof pieces / sizeof *pieces)
+
+static uint8_t *blocks[BLOCK_CNT];
+
+static bool
+same_stats (const struct palloc_stats *a, const struct palloc_stats *b)
+{
+  return a->free_pages == b->free_pages
+         && !memcmp (a->free_blocks, b->free_blocks, sizeof a->free_blocks);
+}
+
+void
+test_palloc_buddy (void)
+{
+  struct palloc_stats start, after_pieces, after_mixed;
+  uint8_t *big, *again, *again2;
+  bool overlap = false;
+  size_t i;
+
+  /* Nothing is printed until the end: printing can block, and the
+     idle thread would then refill its zeroed pages from the pool. */
+  palloc_get_stats (0, &start);
+
+  big = palloc_get_multiple (PAL_ASSERT, BIG_PAGES);
+  for (i = 0; i < PIECE_CNT; i++)
+    palloc_free_multiple (big + pieces[i].ofs * PGSIZE, pieces[i].cnt);
+  palloc_get_stats (0, &after_pieces);
+  again = palloc_get_multiple (PAL_ASSERT, BIG_PAGES);
+  palloc_free_multiple (again, BIG_PAGES);
+
+  for (i = 0; i < BLOCK_CNT; i++)
+    {
+      size_t cnt = block_sizes[i % SIZE_CNT];
+
+      blocks[i] = palloc_get_multiple (PAL_ASSERT, cnt);
+      blocks[i][0] = i;
+      blocks[i][cnt * PGSIZE - 1] = i;
+    }
+  for (i = 0; i < BLOCK_CNT; i++)
+    {
+      size_t cnt = block_sizes[i % SIZE_CNT];
+
+      if (blocks[i][0] != i || blocks[i][cnt * PGSIZE - 1] != i)
+        overlap = true;
+    }
+  for (i = 1; i < BLOCK_CNT; i += 2)
+    palloc_free_multiple (blocks[i], block_sizes[i % SIZE_CNT]);
+  for (i = BLOCK_CNT; i-- > 0; )
+    if (i % 2 == 0)
+      palloc_free_multiple (blocks[i], block_sizes[i % SIZE_CNT]);
+  palloc_get_stats (0, &after_mixed);
+  again2 = palloc_get_multiple (PAL_ASSERT, BIG_PAGES);
+  palloc_free_multiple (again2, BIG_PAGES);
+
+  if (!same_stats (&start, &after_pieces))
+    fail ("free lists differ after freeing the large block in pieces");
+  msg ("large block coalesced after freeing in pieces");
+  if (again != big)
+    fail ("large block not handed out again");
+  msg ("same large block handed out again");
+  if (overlap)
+    fail ("mixed blocks overlap");
+  msg ("%d mixed blocks do not overlap", BLOCK_CNT);
+  if (!same_stats (&start, &after_mixed))
+    fail ("free lists differ after freeing mixed blocks");
+  msg ("pool coalesced after freeing mixed blocks");
+  if (again2 != big)
+    fail ("large block not handed out again");
+  msg ("same large block handed out again");
+  pass ();
+}
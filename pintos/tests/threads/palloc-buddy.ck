@@ -0,0 +1,15 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(palloc-buddy) begin
+(palloc-buddy) large block coalesced after freeing in pieces
+(palloc-buddy) same large block handed out again
+(palloc-buddy) 40 mixed blocks do not overlap
+(palloc-buddy) pool coalesced after freeing mixed blocks
+(palloc-buddy) same large block handed out again
+(palloc-buddy) PASS
+(palloc-buddy) end
+EOF
+pass;
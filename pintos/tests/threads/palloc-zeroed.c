@@ -0,0 +1,75 @@
+/* Checks the idle thread's reserve of zeroed pages.  The reserve
+   is emptied, pages are scribbled on and freed, and the idle thread
+   is given time to refill the reserve.  Every PAL_ZERO page handed
+   out afterwards must come from the reserve and read as all zeros. */
+
+#include <stdio.h>
+#include <string.h>
+#include "tests/threads/tests.h"
+#include "threads/palloc.h"
+#include "threads/vaddr.h"
+#include "devices/timer.h"
+
+#define MAX_PAGES 64
+
+static uint8_t *pages[MAX_PAGES];
+static uint8_t *dirty[MAX_PAGES];
+
+void
+test_palloc_zeroed (void)
+{
+  struct palloc_stats before, after;
+  size_t taken, i, j;
+  bool nonzero = false;
+
+  /* Let idle fill the reserve, then take all of it and scribble on
+     that many plain pages, so a refill has to zero dirty pages. */
+  timer_sleep (10);
+  palloc_get_stats (0, &before);
+  taken = before.zeroed_cnt < MAX_PAGES ? before.zeroed_cnt : MAX_PAGES;
+  for (i = 0; i < taken; i++)
+    pages[i] = palloc_get_page (PAL_ASSERT | PAL_ZERO);
+  for (i = 0; i < taken; i++)
+    {
+      dirty[i] = palloc_get_page (PAL_ASSERT);
+      memset (dirty[i], 0xcc, PGSIZE);
+    }
+  for (i = 0; i < taken; i++)
+    {
+      palloc_free_page (dirty[i]);
+      palloc_free_page (pages[i]);
+    }
+
+  /* Nothing is printed until the end: printing can block, and the
+     idle thread would then refill the reserve between snapshots. */
+  timer_sleep (10);
+  palloc_get_stats (0, &before);
+  taken = before.zeroed_cnt < MAX_PAGES ? before.zeroed_cnt : MAX_PAGES;
+  for (i = 0; i < taken; i++)
+    pages[i] = palloc_get_page (PAL_ASSERT | PAL_ZERO);
+  palloc_get_stats (0, &after);
+  for (i = 0; i < taken; i++)
+    for (j = 0; j < PGSIZE; j++)
+      if (pages[i][j] != 0)
+        nonzero = true;
+  for (i = 0; i < taken; i++)
+    palloc_free_page (pages[i]);
+
+  if (taken == 0)
+    fail ("idle thread did not refill the zeroed reserve");
+  msg ("idle thread refilled the zeroed reserve");
+  if (nonzero)
+    fail ("PAL_ZERO page is not all zeros");
+  msg ("PAL_ZERO pages are all zeros");
+  if (after.zero_hits - before.zero_hits != taken
+      || after.zero_misses != before.zero_misses)
+    fail ("%llu hits and %llu misses for %zu PAL_ZERO pages",
+          (unsigned long long) (after.zero_hits - before.zero_hits),
+          (unsigned long long) (after.zero_misses - before.zero_misses),
+          taken);
+  msg ("every PAL_ZERO page was a reserve hit");
+  if (after.zeroed_cnt != before.zeroed_cnt - taken)
+    fail ("reserve did not shrink by the pages taken");
+  msg ("reserve shrank by the pages taken");
+  pass ();
+}
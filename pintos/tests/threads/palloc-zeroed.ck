@@ -0,0 +1,14 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(palloc-zeroed) begin
+(palloc-zeroed) idle thread refilled the zeroed reserve
+(palloc-zeroed) PAL_ZERO pages are all zeros
+(palloc-zeroed) every PAL_ZERO page was a reserve hit
+(palloc-zeroed) reserve shrank by the pages taken
+(palloc-zeroed) PASS
+(palloc-zeroed) end
+EOF
+pass;
@@ -0,0 +1,104 @@
+/* Checks the slab allocator with several object sizes at once.
+   Objects are allocated from four caches in turn, filled with a
+   pattern and freed out of order.  Afterward every cache must have
+   freed as many objects as it allocated, empty slabs must have gone
+   back to the page allocator, and the kernel pool must be short by
+   exactly the slabs the caches still hold. */
+
+#include <stdio.h>
+#include <string.h>
+#include <round.h>
+#include "tests/threads/tests.h"
+#include "threads/palloc.h"
+#include "threads/slab.h"
+
+#define CACHE_CNT 4
+#define OBJ_CNT 300
+
+static const char *cache_names[CACHE_CNT] =
+  {"test-24", "test-120", "test-600", "test-2000"};
+static const size_t obj_sizes[CACHE_CNT] = {24, 120, 600, 2000};
+
+static struct kmem_cache caches[CACHE_CNT];
+static uint8_t *objs[CACHE_CNT][OBJ_CNT];
+
+void
+test_slab_mixed (void)
+{
+  struct palloc_stats start, end;
+  uint64_t peak_slabs[CACHE_CNT];
+  bool alloc_failed = false, overlap = false;
+  size_t held = 0;
+  int c, i;
+
+  /* Nothing is printed until the end: printing can block, and the
+     idle thread would then refill its zeroed pages from the pool. */
+  palloc_get_stats (0, &start);
+
+  for (c = 0; c < CACHE_CNT; c++)
+    kmem_cache_init (&caches[c], cache_names[c], obj_sizes[c], NULL);
+
+  for (i = 0; i < OBJ_CNT; i++)
+    for (c = 0; c < CACHE_CNT; c++)
+      {
+        objs[c][i] = kmem_cache_alloc (&caches[c]);
+        if (objs[c][i] == NULL)
+          alloc_failed = true;
+        else
+          memset (objs[c][i], c * OBJ_CNT + i, obj_sizes[c]);
+      }
+  for (c = 0; c < CACHE_CNT; c++)
+    {
+      peak_slabs[c] = caches[c].slabs;
+      for (i = 0; i < OBJ_CNT; i++)
+        if (objs[c][i] != NULL
+            && (objs[c][i][0] != (uint8_t) (c * OBJ_CNT + i)
+                || objs[c][i][obj_sizes[c] - 1] != (uint8_t) (c * OBJ_CNT + i)))
+          overlap = true;
+    }
+
+  for (c = 0; c < CACHE_CNT; c++)
+    {
+      for (i = 1; i < OBJ_CNT; i += 2)
+        kmem_cache_free (&caches[c], objs[c][i]);
+      for (i = OBJ_CNT - 1; i >= 0; i--)
+        if (i % 2 == 0)
+          kmem_cache_free (&caches[c], objs[c][i]);
+      held += caches[c].slabs;
+    }
+  palloc_get_stats (0, &end);
+
+  if (alloc_failed)
+    fail ("kmem_cache_alloc() returned NULL");
+  msg ("allocated %d objects from each of %d caches", OBJ_CNT, CACHE_CNT);
+  if (overlap)
+    fail ("objects overlap");
+  msg ("objects do not overlap");
+
+  for (c = 0; c < CACHE_CNT; c++)
+    {
+      struct kmem_cache *k = &caches[c];
+
+      /* Objects parked in the magazine still count as allocated to
+         their slabs, so those slabs stay.  One more empty slab may be
+         kept as the last partial slab. */
+      size_t max_slabs = DIV_ROUND_UP (KMEM_MAG_SIZE, k->objs_per_slab) + 1;
+
+      if (k->allocs != OBJ_CNT || k->frees != OBJ_CNT)
+        fail ("%s: %llu allocs, %llu frees", k->name,
+              (unsigned long long) k->allocs, (unsigned long long) k->frees);
+      if (peak_slabs[c] < DIV_ROUND_UP (OBJ_CNT, k->objs_per_slab))
+        fail ("%s: %llu slabs for %d objects", k->name,
+              (unsigned long long) peak_slabs[c], OBJ_CNT);
+      if (k->slabs > max_slabs)
+        fail ("%s: %llu slabs left after freeing everything", k->name,
+              (unsigned long long) k->slabs);
+    }
+  msg ("every cache freed its objects and returned empty slabs");
+
+  if (end.free_pages + held != start.free_pages)
+    fail ("kernel pool short by %zu pages, caches hold %zu slabs",
+          start.free_pages - end.free_pages, held);
+  msg ("kernel pool short by exactly the slabs still held");
+  pass ();
+}
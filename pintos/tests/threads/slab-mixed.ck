@@ -0,0 +1,14 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(slab-mixed) begin
+(slab-mixed) allocated 300 objects from each of 4 caches
+(slab-mixed) objects do not overlap
+(slab-mixed) every cache freed its objects and returned empty slabs
+(slab-mixed) kernel pool short by exactly the slabs still held
+(slab-mixed) PASS
+(slab-mixed) end
+EOF
+pass;
@@ -0,0 +1,15 @@
+/* Child process of text-share.
+   Exits with the number of the frame that holds the page of its own
+   code, so the parent can compare the frames of two runs. */
+
+#include <stdint.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+int
+main (void)
+{
+  test_name = "child-text";
+  return (int) ((uintptr_t) get_phys_addr ((void *) main) >> 12);
+}
@@ -0,0 +1,29 @@
+/* Child process of exec-trace.
+   Reads through its initialized data and exits with the number of
+   first-touch faults it took on anonymous and executable pages since
+   it was loaded. */
+
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+#include "tests/vm/small.inc"
+
+static struct pfstat stats;
+
+int
+main (void)
+{
+  unsigned sum = 0;
+  size_t i;
+
+  test_name = "child-trace";
+
+  for (i = 0; i < sizeof small; i++)
+    sum += (unsigned char) small[i];
+  if (sum == 0)
+    fail ("initialized data reads as zeros");
+
+  if (pfstat (&stats) != 0)
+    fail ("pfstat failed");
+  return stats.proc_count[FAULT_UNINIT_ANON];
+}
@@ -0,0 +1,80 @@
+/* Checks copy-on-write of anonymous memory across fork.  The child
+   shares the parent's frames until it writes to them, and its writes
+   never reach the parent.  Once the child has exited, the parent is
+   the last sharer, so its own writes reuse the frames in place. */
+
+#include <stdint.h>
+#include <string.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define PAGE_SIZE 4096
+#define PAGE_CNT 4
+
+static char buf[(PAGE_CNT + 1) * PAGE_SIZE];
+static struct pfstat before, after;
+
+static bool
+all_bytes (const char *p, char c)
+{
+  size_t i;
+
+  for (i = 0; i < PAGE_CNT * PAGE_SIZE; i++)
+    if (p[i] != c)
+      return false;
+  return true;
+}
+
+void
+test_main (void)
+{
+  char *pages = (char *) (((uintptr_t) buf + PAGE_SIZE - 1)
+                          & ~(uintptr_t) (PAGE_SIZE - 1));
+  void *pa[PAGE_CNT];
+  bool same;
+  pid_t child;
+  int i;
+
+  memset (&before, 0, sizeof before);
+  memset (&after, 0, sizeof after);
+  memset (pages, 'p', PAGE_CNT * PAGE_SIZE);
+  for (i = 0; i < PAGE_CNT; i++)
+    pa[i] = get_phys_addr (pages + i * PAGE_SIZE);
+
+  child = fork ("child");
+  if (child == 0)
+    {
+      same = true;
+      for (i = 0; i < PAGE_CNT; i++)
+        same = same && get_phys_addr (pages + i * PAGE_SIZE) == pa[i];
+      CHECK (same, "child shares the parent's frames");
+
+      pfstat (&before);
+      memset (pages, 'c', PAGE_CNT * PAGE_SIZE);
+      pfstat (&after);
+      CHECK (after.proc_count[FAULT_COW] - before.proc_count[FAULT_COW]
+             == PAGE_CNT, "one copy-on-write fault per page");
+
+      same = false;
+      for (i = 0; i < PAGE_CNT; i++)
+        same = same || get_phys_addr (pages + i * PAGE_SIZE) == pa[i];
+      CHECK (!same, "child got its own frames");
+      CHECK (all_bytes (pages, 'c'), "child sees its own writes");
+      return;
+    }
+  wait (child);
+
+  CHECK (all_bytes (pages, 'p'), "parent's data unchanged");
+  same = true;
+  for (i = 0; i < PAGE_CNT; i++)
+    same = same && get_phys_addr (pages + i * PAGE_SIZE) == pa[i];
+  CHECK (same, "parent kept its frames");
+
+  memset (pages, 'q', PAGE_CNT * PAGE_SIZE);
+  same = true;
+  for (i = 0; i < PAGE_CNT; i++)
+    same = same && get_phys_addr (pages + i * PAGE_SIZE) == pa[i];
+  CHECK (same, "parent's writes reused its frames");
+  CHECK (all_bytes (pages, 'q'), "parent sees its own writes");
+}
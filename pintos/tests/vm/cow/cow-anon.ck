@@ -0,0 +1,18 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected (IGNORE_EXIT_CODES => 1, [<<'EOF']);
+(cow-anon) begin
+(cow-anon) child shares the parent's frames
+(cow-anon) one copy-on-write fault per page
+(cow-anon) child got its own frames
+(cow-anon) child sees its own writes
+(cow-anon) end
+(cow-anon) parent's data unchanged
+(cow-anon) parent kept its frames
+(cow-anon) parent's writes reused its frames
+(cow-anon) parent sees its own writes
+(cow-anon) end
+EOF
+pass;
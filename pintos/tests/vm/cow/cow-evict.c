@@ -0,0 +1,82 @@
+/* Checks eviction of frames shared by copy-on-write.
+   For this test, Pintos memory size is 8MB.
+   The parent fills a region and forks, so the child shares its
+   frames.  The child then streams through more anonymous memory than
+   fits, which evicts the shared frames while both processes still map
+   them.  Each process must read the region back intact afterwards,
+   and the parent must then be able to write to it. */
+
+#include <stdint.h>
+#include <string.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define PAGE_SHIFT 12
+#define PAGE_SIZE (1 << PAGE_SHIFT)
+#define ONE_MB (1 << 20)
+#define CHUNK_SIZE (12 * ONE_MB)
+#define PAGE_COUNT (CHUNK_SIZE / PAGE_SIZE)
+#define SHARED_CNT 64
+
+static char shared[(SHARED_CNT + 1) * PAGE_SIZE];
+static char big_chunks[CHUNK_SIZE];
+
+/* Byte J of shared page I. */
+static char
+pattern (size_t i, size_t j)
+{
+  return (char) (i * 7 + j / 256 + 1);
+}
+
+/* Checks a sample of the bytes of the shared region at PAGES.  If
+   WRITTEN, the first byte of every even page must hold 'w' instead. */
+static bool
+region_intact (const char *pages, bool written)
+{
+  size_t i, j;
+
+  for (i = 0; i < SHARED_CNT; i++)
+    for (j = 0; j < PAGE_SIZE; j += 256)
+      {
+        char c = written && i % 2 == 0 && j == 0 ? 'w' : pattern (i, j);
+
+        if (pages[i * PAGE_SIZE + j] != c)
+          return false;
+      }
+  return true;
+}
+
+void
+test_main (void)
+{
+  char *pages = (char *) (((uintptr_t) shared + PAGE_SIZE - 1)
+                          & ~(uintptr_t) (PAGE_SIZE - 1));
+  pid_t child;
+  size_t i, j;
+
+  for (i = 0; i < SHARED_CNT; i++)
+    for (j = 0; j < PAGE_SIZE; j++)
+      pages[i * PAGE_SIZE + j] = pattern (i, j);
+
+  child = fork ("child");
+  if (child == 0)
+    {
+      for (i = 0; i < PAGE_COUNT; i++)
+        big_chunks[i * PAGE_SIZE] = (char) i;
+      for (i = 0; i < PAGE_COUNT; i++)
+        if (big_chunks[i * PAGE_SIZE] != (char) i)
+          fail ("data is inconsistent in page %zu", i);
+      msg ("child streamed %d pages", PAGE_COUNT);
+      CHECK (region_intact (pages, false),
+             "child reads the shared region intact");
+      return;
+    }
+  wait (child);
+
+  CHECK (region_intact (pages, false),
+         "parent reads the shared region intact");
+  for (i = 0; i < SHARED_CNT; i += 2)
+    pages[i * PAGE_SIZE] = 'w';
+  CHECK (region_intact (pages, true), "parent sees its own writes");
+}
@@ -0,0 +1,21 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected (IGNORE_EXIT_CODES => 1, [<<'EOF']);
+(cow-evict) begin
+(cow-evict) child streamed 3072 pages
+(cow-evict) child reads the shared region intact
+(cow-evict) end
+(cow-evict) parent reads the shared region intact
+(cow-evict) parent sees its own writes
+(cow-evict) end
+EOF
+
+our ($test);
+my (@output) = read_text_file ("$test.output");
+my ($stats) = grep (/^Rmap: /, @output);
+fail "missing \"Rmap:\" statistics\n" if !defined $stats;
+my ($evicted) = $stats =~ /(\d+) shared frames evicted/;
+fail "no shared frame was evicted\n" if !$evicted;
+pass;
@@ -0,0 +1,35 @@
+/* Checks that a second exec of the same executable is prefetched from
+   the fault trace recorded by the first.  Runs child-trace twice, one
+   after the other; each run exits with the number of first-touch
+   faults it took, and the second run must take fewer. */
+
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+/* Runs child-trace to completion and returns its exit status. */
+static int
+run_child (void)
+{
+  pid_t child = fork ("child-trace");
+
+  if (child == 0)
+    {
+      if (exec ("child-trace") == -1)
+        fail ("failed to exec child-trace");
+    }
+  return wait (child);
+}
+
+void
+test_main (void)
+{
+  int first, second;
+
+  first = run_child ();
+  CHECK (first > 0, "first run faults its pages in");
+  second = run_child ();
+  if (second < 0 || second >= first)
+    fail ("first run took %d faults, second run %d", first, second);
+  msg ("second run takes fewer faults");
+}
@@ -0,0 +1,19 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected (IGNORE_EXIT_CODES => 1, [<<'EOF']);
+(exec-trace) begin
+(exec-trace) first run faults its pages in
+(exec-trace) second run takes fewer faults
+(exec-trace) end
+EOF
+
+our ($test);
+my (@output) = read_text_file ("$test.output");
+my ($stats) = grep (/^Exec trace: /, @output);
+fail "missing \"Exec trace:\" statistics: tracing is off\n"
+  if !defined $stats;
+my ($prefetched) = $stats =~ /(\d+) execs prefetched/;
+fail "no exec was prefetched from a trace\n" if !$prefetched;
+pass;
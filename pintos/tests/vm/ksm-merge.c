@@ -0,0 +1,62 @@
+/* Checks same-page merging.  Fills two anonymous pages with the same
+   contents and waits for the merging daemon to back both with one
+   frame.  Then writes to one of them, which must take a single
+   copy-on-write fault and move it to a frame of its own, while the
+   other page keeps its contents. */
+
+#include <stdint.h>
+#include <string.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define PAGE_SIZE 4096
+#define SPIN_MAX 10000000
+
+static char buf[3 * PAGE_SIZE];
+static struct pfstat before, after;
+
+void
+test_main (void)
+{
+  char *a = (char *) (((uintptr_t) buf + PAGE_SIZE - 1)
+                      & ~(uintptr_t) (PAGE_SIZE - 1));
+  char *b = a + PAGE_SIZE;
+  uint64_t cow;
+  int i;
+
+  /* Give the snapshot buffers contents no other page has, so that only
+     A and B are candidates for merging. */
+  memset (&before, 0, sizeof before);
+  memset (&after, 0, sizeof after);
+  pfstat (&after);
+  pfstat (&before);
+
+  for (i = 0; i < PAGE_SIZE; i++)
+    a[i] = b[i] = (char) (i * 7 + 1);
+
+  for (i = 0; i < SPIN_MAX; i++)
+    if (get_phys_addr (a) == get_phys_addr (b))
+      break;
+  if (i == SPIN_MAX)
+    fail ("identical pages were never merged");
+  msg ("identical pages merged into one frame");
+
+  pfstat (&before);
+  a[0] = 'x';
+  pfstat (&after);
+  cow = after.proc_count[FAULT_COW] - before.proc_count[FAULT_COW];
+  CHECK (cow == 1, "write to a merged page takes one copy-on-write fault");
+  CHECK (get_phys_addr (a) != get_phys_addr (b),
+         "written page moved to its own frame");
+
+  if (a[0] != 'x')
+    fail ("written page lost the write");
+  for (i = 1; i < PAGE_SIZE; i++)
+    if (a[i] != (char) (i * 7 + 1))
+      fail ("written page changed at byte %d", i);
+  for (i = 0; i < PAGE_SIZE; i++)
+    if (b[i] != (char) (i * 7 + 1))
+      fail ("other page changed at byte %d", i);
+  msg ("both pages hold their own contents");
+}
@@ -0,0 +1,13 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected (IGNORE_EXIT_CODES => 1, [<<'EOF']);
+(ksm-merge) begin
+(ksm-merge) identical pages merged into one frame
+(ksm-merge) write to a merged page takes one copy-on-write fault
+(ksm-merge) written page moved to its own frame
+(ksm-merge) both pages hold their own contents
+(ksm-merge) end
+EOF
+pass;
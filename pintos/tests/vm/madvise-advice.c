@@ -0,0 +1,52 @@
+/* Gives every madvise() advice for a file mapping and for BSS memory
+   and checks that each call succeeds and leaves the contents intact. */
+
+#include <stdint.h>
+#include <string.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+#include "tests/vm/small.inc"
+
+#define PAGE_SIZE 4096
+#define ACTUAL ((char *) 0x10000000)
+
+static char bss[3 * PAGE_SIZE];
+
+void
+test_main (void)
+{
+  static const char *names[] = {
+    "MADV_NORMAL", "MADV_RANDOM", "MADV_SEQUENTIAL",
+    "MADV_WILLNEED", "MADV_DONTNEED"
+  };
+  char *page = (char *) (((uintptr_t) bss + PAGE_SIZE - 1)
+                         & ~(uintptr_t) (PAGE_SIZE - 1));
+  size_t size = strlen (small);
+  int handle;
+  int advice;
+
+  CHECK ((handle = open ("small.txt")) > 1, "open \"small.txt\"");
+  CHECK (mmap (ACTUAL, size, 0, handle, 0) != MAP_FAILED,
+         "mmap \"small.txt\"");
+
+  for (advice = MADV_NORMAL; advice <= MADV_DONTNEED; advice++)
+    {
+      CHECK (madvise (ACTUAL, size, advice) == 0,
+             "%s on file mapping", names[advice]);
+      if (memcmp (ACTUAL, small, size))
+        fail ("file mapping changed after %s", names[advice]);
+    }
+
+  for (advice = MADV_NORMAL; advice < MADV_DONTNEED; advice++)
+    {
+      memset (page, advice + 1, PAGE_SIZE);
+      CHECK (madvise (page, PAGE_SIZE, advice) == 0,
+             "%s on anonymous memory", names[advice]);
+      if (page[0] != advice + 1 || page[PAGE_SIZE - 1] != advice + 1)
+        fail ("anonymous page changed after %s", names[advice]);
+    }
+
+  munmap (ACTUAL);
+  close (handle);
+}
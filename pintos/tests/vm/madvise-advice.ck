@@ -0,0 +1,20 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected (IGNORE_EXIT_CODES => 1, [<<'EOF']);
+(madvise-advice) begin
+(madvise-advice) open "small.txt"
+(madvise-advice) mmap "small.txt"
+(madvise-advice) MADV_NORMAL on file mapping
+(madvise-advice) MADV_RANDOM on file mapping
+(madvise-advice) MADV_SEQUENTIAL on file mapping
+(madvise-advice) MADV_WILLNEED on file mapping
+(madvise-advice) MADV_DONTNEED on file mapping
+(madvise-advice) MADV_NORMAL on anonymous memory
+(madvise-advice) MADV_RANDOM on anonymous memory
+(madvise-advice) MADV_SEQUENTIAL on anonymous memory
+(madvise-advice) MADV_WILLNEED on anonymous memory
+(madvise-advice) end
+EOF
+pass;
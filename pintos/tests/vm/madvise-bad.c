@@ -0,0 +1,44 @@
+/* Passes bad arguments to madvise(): an unknown advice, a misaligned
+   address, a zero length, a kernel address, an unmapped range and a
+   range that runs past the end of a mapping.  Each call must fail
+   with -1 without killing the process or touching the mapping. */
+
+#include <string.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+#include "tests/vm/small.inc"
+
+#define PAGE_SIZE 4096
+#define ACTUAL ((char *) 0x10000000)
+
+void
+test_main (void)
+{
+  size_t size = strlen (small);
+  int handle;
+
+  CHECK ((handle = open ("small.txt")) > 1, "open \"small.txt\"");
+  CHECK (mmap (ACTUAL, size, 0, handle, 0) != MAP_FAILED,
+         "mmap \"small.txt\"");
+
+  CHECK (madvise (ACTUAL, PAGE_SIZE, MADV_DONTNEED + 1) == -1,
+         "madvise with advice %d", MADV_DONTNEED + 1);
+  CHECK (madvise (ACTUAL, PAGE_SIZE, -1) == -1, "madvise with advice -1");
+  CHECK (madvise (ACTUAL + 1, PAGE_SIZE, MADV_NORMAL) == -1,
+         "madvise at misaligned address");
+  CHECK (madvise (ACTUAL, 0, MADV_NORMAL) == -1, "madvise with length 0");
+  CHECK (madvise ((void *) 0x8004000000, PAGE_SIZE, MADV_WILLNEED) == -1,
+         "madvise on kernel address");
+  CHECK (madvise ((void *) 0x20000000, PAGE_SIZE, MADV_WILLNEED) == -1,
+         "madvise on unmapped range");
+  CHECK (madvise (ACTUAL, 16 * PAGE_SIZE, MADV_DONTNEED) == -1,
+         "madvise past end of mapping");
+
+  if (memcmp (ACTUAL, small, size))
+    fail ("mapping changed by a failed madvise");
+  msg ("mapping intact");
+
+  munmap (ACTUAL);
+  close (handle);
+}
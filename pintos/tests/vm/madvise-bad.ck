@@ -0,0 +1,19 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected (IGNORE_EXIT_CODES => 1, [<<'EOF']);
+(madvise-bad) begin
+(madvise-bad) open "small.txt"
+(madvise-bad) mmap "small.txt"
+(madvise-bad) madvise with advice 5
+(madvise-bad) madvise with advice -1
+(madvise-bad) madvise at misaligned address
+(madvise-bad) madvise with length 0
+(madvise-bad) madvise on kernel address
+(madvise-bad) madvise on unmapped range
+(madvise-bad) madvise past end of mapping
+(madvise-bad) mapping intact
+(madvise-bad) end
+EOF
+pass;
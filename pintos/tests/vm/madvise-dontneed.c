@@ -0,0 +1,51 @@
+/* Checks what MADV_DONTNEED leaves behind.  Anonymous memory loses
+   its contents and reads back as zeros; a file mapping is read from
+   the file again. */
+
+#include <stdint.h>
+#include <string.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+#include "tests/vm/small.inc"
+
+#define PAGE_SIZE 4096
+#define ACTUAL ((char *) 0x10000000)
+
+static char bss[4 * PAGE_SIZE];
+
+void
+test_main (void)
+{
+  char *page = (char *) (((uintptr_t) bss + PAGE_SIZE - 1)
+                         & ~(uintptr_t) (PAGE_SIZE - 1));
+  size_t size = strlen (small);
+  int handle;
+  size_t i;
+
+  memset (page, 'x', 2 * PAGE_SIZE);
+  CHECK (madvise (page, PAGE_SIZE, MADV_DONTNEED) == 0,
+         "MADV_DONTNEED on written anonymous page");
+  for (i = 0; i < PAGE_SIZE; i++)
+    if (page[i] != 0)
+      fail ("byte %zu of dropped page is %02hhx (should be 0)", i, page[i]);
+  msg ("dropped page reads back as zeros");
+  for (i = PAGE_SIZE; i < 2 * PAGE_SIZE; i++)
+    if (page[i] != 'x')
+      fail ("byte %zu of the next page was lost", i);
+  msg ("next page kept its contents");
+
+  CHECK ((handle = open ("small.txt")) > 1, "open \"small.txt\"");
+  CHECK (mmap (ACTUAL, size, 0, handle, 0) != MAP_FAILED,
+         "mmap \"small.txt\"");
+  if (memcmp (ACTUAL, small, size))
+    fail ("read of mmap'd file reported bad data");
+  CHECK (madvise (ACTUAL, size, MADV_DONTNEED) == 0,
+         "MADV_DONTNEED on file mapping");
+  if (memcmp (ACTUAL, small, size))
+    fail ("file mapping not read back from the file");
+  msg ("file mapping read back from the file");
+
+  munmap (ACTUAL);
+  close (handle);
+}
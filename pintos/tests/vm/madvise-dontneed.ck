@@ -0,0 +1,16 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected (IGNORE_EXIT_CODES => 1, [<<'EOF']);
+(madvise-dontneed) begin
+(madvise-dontneed) MADV_DONTNEED on written anonymous page
+(madvise-dontneed) dropped page reads back as zeros
+(madvise-dontneed) next page kept its contents
+(madvise-dontneed) open "small.txt"
+(madvise-dontneed) mmap "small.txt"
+(madvise-dontneed) MADV_DONTNEED on file mapping
+(madvise-dontneed) file mapping read back from the file
+(madvise-dontneed) end
+EOF
+pass;
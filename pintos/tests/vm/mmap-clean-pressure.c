@@ -0,0 +1,80 @@
+/* Dirties every page of a writable mapping of "large.txt", then
+   streams through an anonymous region larger than memory so that the
+   mapped pages are evicted while the dirty page cleaner is running.
+   For this test, Pintos memory size is 8MB.
+   The mapping must still read back the modified bytes, and after
+   munmap the file must hold them as well. */
+
+#include <string.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define PAGE_SHIFT 12
+#define PAGE_SIZE (1 << PAGE_SHIFT)
+#define ONE_MB (1 << 20)
+#define CHUNK_SIZE (12 * ONE_MB)
+#define PAGE_COUNT (CHUNK_SIZE / PAGE_SIZE)
+#define FILE_PAGES_MAX 512
+#define ACTUAL ((char *) 0x10000000)
+
+static char big_chunks[CHUNK_SIZE];
+static char orig[FILE_PAGES_MAX];
+static char buf[PAGE_SIZE];
+
+/* Byte written to the start of file page I. */
+static char
+marker (size_t i)
+{
+  return 'A' + i % 26;
+}
+
+void
+test_main (void)
+{
+  size_t size, file_pages, i;
+  int handle;
+
+  CHECK ((handle = open ("large.txt")) > 1, "open \"large.txt\"");
+  size = filesize (handle);
+  file_pages = (size + PAGE_SIZE - 1) / PAGE_SIZE;
+  if (file_pages > FILE_PAGES_MAX)
+    fail ("\"large.txt\" is %zu pages", file_pages);
+  CHECK (mmap (ACTUAL, size, 1, handle, 0) != MAP_FAILED,
+         "mmap \"large.txt\" writable");
+
+  for (i = 0; i < file_pages; i++)
+    {
+      orig[i] = ACTUAL[i * PAGE_SIZE + 1];
+      ACTUAL[i * PAGE_SIZE] = marker (i);
+    }
+  msg ("dirtied %zu mapped pages", file_pages);
+
+  for (i = 0; i < PAGE_COUNT; i++)
+    big_chunks[i * PAGE_SIZE] = (char) i;
+  for (i = 0; i < PAGE_COUNT; i++)
+    if (big_chunks[i * PAGE_SIZE] != (char) i)
+      fail ("anonymous data is inconsistent in page %zu", i);
+  msg ("streamed %d anonymous pages", PAGE_COUNT);
+
+  for (i = 0; i < file_pages; i++)
+    if (ACTUAL[i * PAGE_SIZE] != marker (i)
+        || ACTUAL[i * PAGE_SIZE + 1] != orig[i])
+      fail ("mapped page %zu lost its contents", i);
+  msg ("mapping kept the changes");
+  munmap (ACTUAL);
+
+  seek (handle, 0);
+  for (i = 0; i < file_pages; i++)
+    {
+      size_t chunk = size - i * PAGE_SIZE < PAGE_SIZE
+                     ? size - i * PAGE_SIZE : PAGE_SIZE;
+
+      if (read (handle, buf, chunk) != (int) chunk)
+        fail ("read \"large.txt\" page %zu", i);
+      if (buf[0] != marker (i) || buf[1] != orig[i])
+        fail ("file page %zu does not hold the change", i);
+    }
+  msg ("file holds the changes after munmap");
+  close (handle);
+}
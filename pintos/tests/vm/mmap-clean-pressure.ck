@@ -0,0 +1,22 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected (IGNORE_EXIT_CODES => 1, [<<'EOF']);
+(mmap-clean-pressure) begin
+(mmap-clean-pressure) open "large.txt"
+(mmap-clean-pressure) mmap "large.txt" writable
+(mmap-clean-pressure) dirtied 490 mapped pages
+(mmap-clean-pressure) streamed 3072 anonymous pages
+(mmap-clean-pressure) mapping kept the changes
+(mmap-clean-pressure) file holds the changes after munmap
+(mmap-clean-pressure) end
+EOF
+
+our ($test);
+my (@output) = read_text_file ("$test.output");
+my ($stats) = grep (/^Cleaner: /, @output);
+fail "missing \"Cleaner:\" statistics\n" if !defined $stats;
+my ($written) = $stats =~ /(\d+) pages written back ahead of eviction/;
+fail "dirty page cleaner wrote back no pages\n" if !$written;
+pass;
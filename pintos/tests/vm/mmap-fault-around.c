@@ -0,0 +1,89 @@
+/* Reads a mapping of "large.txt" one byte per page, in order, and
+   checks that fault-around maps the following pages along with each
+   faulting one, so the faults are only a fraction of the pages.  Then
+   maps the file again with MADV_RANDOM and checks that every page
+   faults on its own.  Both mappings must match the file. */
+
+#include <string.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define PAGE_SIZE 4096
+#define SEQ ((char *) 0x10000000)
+#define RND ((char *) 0x20000000)
+
+static struct pfstat before, after;
+static char buf[PAGE_SIZE];
+
+/* Touches one byte of each of the PAGE_CNT pages at MAP and returns the
+   number of first-touch mmap faults it took. */
+static int
+touch_pages (const char *map, size_t page_cnt)
+{
+  volatile char sink = 0;
+  size_t i;
+
+  pfstat (&before);
+  for (i = 0; i < page_cnt; i++)
+    sink += map[i * PAGE_SIZE];
+  pfstat (&after);
+  (void) sink;
+  return after.proc_count[FAULT_UNINIT_FILE]
+         - before.proc_count[FAULT_UNINIT_FILE];
+}
+
+/* Checks that MAP holds the SIZE bytes of the file open as HANDLE. */
+static void
+check_mapping (const char *map, int handle, size_t size, const char *name)
+{
+  size_t ofs;
+
+  seek (handle, 0);
+  for (ofs = 0; ofs < size; ofs += PAGE_SIZE)
+    {
+      size_t chunk = size - ofs < PAGE_SIZE ? size - ofs : PAGE_SIZE;
+
+      if (read (handle, buf, chunk) != (int) chunk)
+        fail ("read \"large.txt\" at offset %zu", ofs);
+      if (memcmp (map + ofs, buf, chunk))
+        fail ("%s mapping differs from file at offset %zu", name, ofs);
+    }
+}
+
+void
+test_main (void)
+{
+  size_t size, page_cnt;
+  int handle, faults;
+
+  memset (&before, 0, sizeof before);
+  memset (&after, 0, sizeof after);
+
+  CHECK ((handle = open ("large.txt")) > 1, "open \"large.txt\"");
+  size = filesize (handle);
+  page_cnt = (size + PAGE_SIZE - 1) / PAGE_SIZE;
+
+  CHECK (mmap (SEQ, size, 0, handle, 0) != MAP_FAILED,
+         "mmap \"large.txt\"");
+  faults = touch_pages (SEQ, page_cnt);
+  if (faults <= 0 || (size_t) faults * 4 > page_cnt)
+    fail ("sequential read of %zu pages took %d faults",
+          page_cnt, faults);
+  msg ("sequential read faults on a fraction of the pages");
+  check_mapping (SEQ, handle, size, "sequential");
+
+  CHECK (mmap (RND, size, 0, handle, 0) != MAP_FAILED,
+         "mmap \"large.txt\" again");
+  CHECK (madvise (RND, size, MADV_RANDOM) == 0, "MADV_RANDOM");
+  faults = touch_pages (RND, page_cnt);
+  if ((size_t) faults != page_cnt)
+    fail ("MADV_RANDOM read of %zu pages took %d faults",
+          page_cnt, faults);
+  msg ("MADV_RANDOM read faults on every page");
+  check_mapping (RND, handle, size, "random");
+
+  munmap (RND);
+  munmap (SEQ);
+  close (handle);
+}
@@ -0,0 +1,15 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected (IGNORE_EXIT_CODES => 1, [<<'EOF']);
+(mmap-fault-around) begin
+(mmap-fault-around) open "large.txt"
+(mmap-fault-around) mmap "large.txt"
+(mmap-fault-around) sequential read faults on a fraction of the pages
+(mmap-fault-around) mmap "large.txt" again
+(mmap-fault-around) MADV_RANDOM
+(mmap-fault-around) MADV_RANDOM read faults on every page
+(mmap-fault-around) end
+EOF
+pass;
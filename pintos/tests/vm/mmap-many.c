@@ -0,0 +1,96 @@
+/* Maps "small.txt" many times at scattered addresses in shuffled
+   order, with a one-page gap after each mapping, and checks every
+   mapping's contents.  Mappings that overlap an existing one must
+   fail, while one that exactly fills a gap must succeed.  Then unmaps
+   every other mapping, checks that the holes are really gone, and
+   maps them again. */
+
+#include <string.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+#include "tests/vm/small.inc"
+
+#define PAGE_SIZE 4096
+#define MAP_CNT 32
+#define MAP_PAGES 3
+#define STRIDE ((MAP_PAGES + 1) * PAGE_SIZE)
+#define BASE ((char *) 0x10000000)
+
+/* Address of the mapping in slot I. */
+static char *
+slot (int i)
+{
+  return BASE + (size_t) i * STRIDE;
+}
+
+/* Visits the slots in a shuffled order: 13 is coprime with MAP_CNT. */
+static int
+order (int i)
+{
+  return i * 13 % MAP_CNT;
+}
+
+static void
+check_slot (int i)
+{
+  if (memcmp (slot (i), small, strlen (small)))
+    fail ("mapping %d has wrong contents", i);
+}
+
+void
+test_main (void)
+{
+  size_t size = strlen (small);
+  int handle;
+  int i;
+
+  CHECK ((handle = open ("small.txt")) > 1, "open \"small.txt\"");
+
+  for (i = 0; i < MAP_CNT; i++)
+    if (mmap (slot (order (i)), size, 0, handle, 0) != slot (order (i)))
+      fail ("mmap %d failed", order (i));
+  msg ("mapped %d regions", MAP_CNT);
+  for (i = MAP_CNT - 1; i >= 0; i--)
+    check_slot (order (i));
+  msg ("all regions intact");
+
+  for (i = 0; i < MAP_CNT; i++)
+    {
+      if (mmap (slot (i) + PAGE_SIZE, PAGE_SIZE, 0, handle, 0) != MAP_FAILED)
+        fail ("mmap inside region %d succeeded", i);
+      if (i + 1 < MAP_CNT
+          && mmap (slot (i) + MAP_PAGES * PAGE_SIZE, 2 * PAGE_SIZE, 0,
+                   handle, 0) != MAP_FAILED)
+        fail ("mmap spanning into region %d succeeded", i + 1);
+    }
+  msg ("overlapping mmaps fail");
+
+  CHECK (mmap (slot (0) + MAP_PAGES * PAGE_SIZE, PAGE_SIZE, 0, handle, 0)
+         != MAP_FAILED, "mmap exactly filling a gap");
+  if (memcmp (slot (0) + MAP_PAGES * PAGE_SIZE, small, PAGE_SIZE))
+    fail ("gap mapping has wrong contents");
+  munmap (slot (0) + MAP_PAGES * PAGE_SIZE);
+
+  for (i = 1; i < MAP_CNT; i += 2)
+    munmap (slot (i));
+  for (i = 1; i < MAP_CNT; i += 2)
+    if (madvise (slot (i), PAGE_SIZE, MADV_WILLNEED) != -1)
+      fail ("madvise on unmapped region %d succeeded", i);
+  CHECK (madvise (slot (0), STRIDE + PAGE_SIZE, MADV_NORMAL) == -1,
+         "madvise across a hole fails");
+  for (i = 0; i < MAP_CNT; i += 2)
+    check_slot (i);
+  msg ("unmapped every other region");
+
+  for (i = MAP_CNT - 1; i > 0; i -= 2)
+    if (mmap (slot (i), size, 0, handle, 0) != slot (i))
+      fail ("mmap %d again failed", i);
+  for (i = 0; i < MAP_CNT; i++)
+    check_slot (order (i));
+  msg ("remapped the holes");
+
+  for (i = 0; i < MAP_CNT; i++)
+    munmap (slot (i));
+  close (handle);
+}
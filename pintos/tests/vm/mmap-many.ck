@@ -0,0 +1,17 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected (IGNORE_EXIT_CODES => 1, [<<'EOF']);
+(mmap-many) begin
+(mmap-many) open "small.txt"
+(mmap-many) mapped 32 regions
+(mmap-many) all regions intact
+(mmap-many) overlapping mmaps fail
+(mmap-many) mmap exactly filling a gap
+(mmap-many) madvise across a hole fails
+(mmap-many) unmapped every other region
+(mmap-many) remapped the holes
+(mmap-many) end
+EOF
+pass;
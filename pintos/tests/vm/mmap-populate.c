@@ -0,0 +1,52 @@
+/* Maps a file with MAP_POPULATE and checks with pfstat() that reading
+   every page of the mapping takes no file faults, then checks that the
+   populated pages hold the file's data. */
+
+#include <string.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+#include "tests/vm/small.inc"
+
+#define PAGE_SIZE 4096
+#define ACTUAL ((char *) 0x10000000)
+
+static struct pfstat before, after;
+
+void
+test_main (void)
+{
+  size_t size = strlen (small);
+  volatile char sum = 0;
+  uint64_t faults;
+  int handle;
+  size_t i;
+
+  memset (&before, 0, sizeof before);
+  memset (&after, 0, sizeof after);
+
+  CHECK ((handle = open ("small.txt")) > 1, "open \"small.txt\"");
+  CHECK (mmap (ACTUAL, size, MAP_POPULATE, handle, 0) != MAP_FAILED,
+         "mmap \"small.txt\" with MAP_POPULATE");
+
+  CHECK (pfstat (&before) == 0, "pfstat before reading");
+  for (i = 0; i < size; i += PAGE_SIZE)
+    sum += ACTUAL[i];
+  sum += ACTUAL[size - 1];
+  CHECK (pfstat (&after) == 0, "pfstat after reading");
+
+  faults = after.proc_count[FAULT_UNINIT_FILE]
+           - before.proc_count[FAULT_UNINIT_FILE]
+           + after.proc_count[FAULT_FILE_REREAD]
+           - before.proc_count[FAULT_FILE_REREAD];
+  if (faults != 0)
+    fail ("%d faults on populated pages", (int) faults);
+  msg ("no faults on populated pages");
+
+  if (memcmp (ACTUAL, small, size))
+    fail ("read of populated mapping reported bad data");
+  msg ("populated data matches file");
+
+  munmap (ACTUAL);
+  close (handle);
+}
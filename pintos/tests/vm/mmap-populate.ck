@@ -0,0 +1,15 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected (IGNORE_EXIT_CODES => 1, [<<'EOF']);
+(mmap-populate) begin
+(mmap-populate) open "small.txt"
+(mmap-populate) mmap "small.txt" with MAP_POPULATE
+(mmap-populate) pfstat before reading
+(mmap-populate) pfstat after reading
+(mmap-populate) no faults on populated pages
+(mmap-populate) populated data matches file
+(mmap-populate) end
+EOF
+pass;
@@ -0,0 +1,61 @@
+/* Touches untouched BSS pages between two pfstat() calls and checks
+   that each page costs exactly one first-touch fault and that the
+   process and system-wide counts agree with each other. */
+
+#include <string.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define PAGE_SIZE 4096
+#define TOUCH_CNT 4
+
+static struct pfstat before, after;
+static char pages[(TOUCH_CNT + 2) * PAGE_SIZE];
+
+void
+test_main (void)
+{
+  uint64_t delta;
+  int cls, b;
+
+  /* Fault in both snapshot buffers before the first call so the kernel's
+     copy-out does not show up between the two snapshots. */
+  memset (&before, 0, sizeof before);
+  memset (&after, 0, sizeof after);
+
+  CHECK (pfstat (&before) == 0, "pfstat before touching");
+  for (b = 1; b <= TOUCH_CNT; b++)
+    pages[b * PAGE_SIZE] = b;
+  CHECK (pfstat (&after) == 0, "pfstat after touching");
+
+  delta = after.proc_count[FAULT_UNINIT_ANON]
+          - before.proc_count[FAULT_UNINIT_ANON];
+  if (delta != TOUCH_CNT)
+    fail ("%d first-touch faults expected, %d counted",
+          TOUCH_CNT, (int) delta);
+  msg ("one first-touch fault per page");
+
+  for (cls = 0; cls < FAULT_CLASS_CNT; cls++)
+    {
+      const struct fault_hist *h = &after.sys[cls];
+      uint64_t sum = 0;
+
+      if (after.proc_count[cls] < before.proc_count[cls]
+          || h->count < before.sys[cls].count)
+        fail ("class %d: count went backwards", cls);
+      if (after.proc_count[cls] > h->count)
+        fail ("class %d: process count exceeds system count", cls);
+      if (after.proc_cycles[cls] > h->cycles)
+        fail ("class %d: process cycles exceed system cycles", cls);
+      if (h->count > 0 && (h->max == 0 || h->max > h->cycles))
+        fail ("class %d: max out of range", cls);
+      for (b = 0; b < FAULT_HIST_BUCKETS; b++)
+        sum += h->buckets[b];
+      if (sum != h->count)
+        fail ("class %d: histogram does not add up to count", cls);
+    }
+  msg ("process and system counts agree");
+
+  CHECK (after.proc_count[FAULT_INVALID] == 0, "no invalid faults");
+}
@@ -0,0 +1,14 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected (IGNORE_EXIT_CODES => 1, [<<'EOF']);
+(pfstat-basic) begin
+(pfstat-basic) pfstat before touching
+(pfstat-basic) pfstat after touching
+(pfstat-basic) one first-touch fault per page
+(pfstat-basic) process and system counts agree
+(pfstat-basic) no invalid faults
+(pfstat-basic) end
+EOF
+pass;
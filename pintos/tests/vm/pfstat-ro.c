@@ -0,0 +1,13 @@
+/* Passes a buffer in the read-only code segment to pfstat().
+   The process must be terminated with -1 exit code. */
+
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+void
+test_main (void)
+{
+  pfstat ((struct pfstat *) test_main);
+  fail ("survived pfstat into code segment");
+}
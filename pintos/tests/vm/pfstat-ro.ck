@@ -0,0 +1,9 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected ([<<'EOF']);
+(pfstat-ro) begin
+pfstat-ro: exit(-1)
+EOF
+pass;
@@ -0,0 +1,53 @@
+/* Checks that eviction gives recently used pages a second chance.
+   For this test, Pintos memory size is 8MB.
+   Streams writes over an anonymous region much larger than memory
+   while touching one hot page after every write.  Once the first round
+   of evictions is over, the hot page must keep the same frame for the
+   rest of the stream: a FIFO policy would evict it once per lap. */
+
+#include <stdint.h>
+#include <string.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define PAGE_SHIFT 12
+#define PAGE_SIZE (1 << PAGE_SHIFT)
+#define ONE_MB (1 << 20)
+#define STREAM_SIZE (20 * ONE_MB)
+#define PAGE_COUNT (STREAM_SIZE / PAGE_SIZE)
+#define WARMUP_COUNT (PAGE_COUNT * 2 / 5)
+
+static char stream[STREAM_SIZE];
+static char hot_buf[2 * PAGE_SIZE];
+
+void
+test_main (void)
+{
+  volatile char *hot = (char *) (((uintptr_t) hot_buf + PAGE_SIZE - 1)
+                                 & ~(uintptr_t) (PAGE_SIZE - 1));
+  void *pa;
+  size_t i;
+
+  *hot = 0;
+  for (i = 0; i < WARMUP_COUNT; i++)
+    {
+      stream[i * PAGE_SIZE] = (char) i;
+      (*hot)++;
+    }
+  msg ("warmed up over %d pages", WARMUP_COUNT);
+
+  pa = get_phys_addr ((void *) hot);
+  CHECK (pa != NULL, "hot page is resident");
+
+  for (i = WARMUP_COUNT; i < PAGE_COUNT; i++)
+    {
+      stream[i * PAGE_SIZE] = (char) i;
+      (*hot)++;
+      if (get_phys_addr ((void *) hot) != pa)
+        fail ("hot page lost its frame at stream page %zu", i);
+    }
+  msg ("hot page kept its frame over %d pages", PAGE_COUNT - WARMUP_COUNT);
+
+  CHECK (*hot == (char) PAGE_COUNT, "hot page counted every write");
+}
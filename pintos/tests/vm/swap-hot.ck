@@ -0,0 +1,13 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected (IGNORE_EXIT_CODES => 1, [<<'EOF']);
+(swap-hot) begin
+(swap-hot) warmed up over 2048 pages
+(swap-hot) hot page is resident
+(swap-hot) hot page kept its frame over 3072 pages
+(swap-hot) hot page counted every write
+(swap-hot) end
+EOF
+pass;
@@ -0,0 +1,49 @@
+/* Checks that swap-in reads neighbouring slots ahead.
+   For this test, Pintos memory size is 8MB.
+   Writes an anonymous region larger than memory in order, so that it
+   is swapped out into consecutive slots, then reads it back in order.
+   With readahead most pages are already in memory when they are
+   touched, so the read pass must take far fewer swap-in faults than
+   it reads pages. */
+
+#include <string.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define PAGE_SHIFT 12
+#define PAGE_SIZE (1 << PAGE_SHIFT)
+#define ONE_MB (1 << 20)
+#define CHUNK_SIZE (12 * ONE_MB)
+#define PAGE_COUNT (CHUNK_SIZE / PAGE_SIZE)
+
+static char big_chunks[CHUNK_SIZE];
+static struct pfstat before, after;
+
+void
+test_main (void)
+{
+  uint64_t faults;
+  size_t i;
+
+  memset (&before, 0, sizeof before);
+  memset (&after, 0, sizeof after);
+
+  for (i = 0; i < PAGE_COUNT; i++)
+    big_chunks[i * PAGE_SIZE] = (char) i;
+  msg ("wrote %d pages", PAGE_COUNT);
+
+  CHECK (pfstat (&before) == 0, "pfstat before reading back");
+  for (i = 0; i < PAGE_COUNT; i++)
+    if (big_chunks[i * PAGE_SIZE] != (char) i)
+      fail ("data is inconsistent in page %zu", i);
+  CHECK (pfstat (&after) == 0, "pfstat after reading back");
+  msg ("read back %d pages", PAGE_COUNT);
+
+  faults = after.proc_count[FAULT_SWAP_IN] - before.proc_count[FAULT_SWAP_IN];
+  if (faults == 0)
+    fail ("no swap-in faults: region was never swapped out");
+  if (faults * 2 > PAGE_COUNT)
+    fail ("%d swap-in faults for %d pages", (int) faults, PAGE_COUNT);
+  msg ("swap-in faults are at most half the pages read");
+}
@@ -0,0 +1,14 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected (IGNORE_EXIT_CODES => 1, [<<'EOF']);
+(swap-readahead) begin
+(swap-readahead) wrote 3072 pages
+(swap-readahead) pfstat before reading back
+(swap-readahead) pfstat after reading back
+(swap-readahead) read back 3072 pages
+(swap-readahead) swap-in faults are at most half the pages read
+(swap-readahead) end
+EOF
+pass;
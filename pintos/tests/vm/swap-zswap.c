@@ -0,0 +1,62 @@
+/* Checks that anonymous pages survive a round trip through the
+   compressed swap cache.
+   For this test, Pintos memory size is 8MB and the cache is on.
+   Writes an anonymous region larger than memory in which most pages
+   compress well and every eighth page is pseudo-random, so both the
+   cache and the swap disk get pages, then reads every page back. */
+
+#include <stdint.h>
+#include <string.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define PAGE_SHIFT 12
+#define PAGE_SIZE (1 << PAGE_SHIFT)
+#define ONE_MB (1 << 20)
+#define CHUNK_SIZE (12 * ONE_MB)
+#define PAGE_COUNT (CHUNK_SIZE / PAGE_SIZE)
+#define WORD_COUNT (PAGE_SIZE / sizeof (uint32_t))
+
+static uint32_t big_chunks[PAGE_COUNT][WORD_COUNT];
+
+/* Word J of page I.  Most pages are a slowly counting sequence, which
+   compresses well; every eighth page is a hash of the word's position
+   and does not compress at all. */
+static uint32_t
+expected_word (size_t i, size_t j)
+{
+  uint32_t x = i * WORD_COUNT + j;
+
+  if (i % 8 != 7)
+    return i << 16 | j / 64;
+  x ^= x >> 16;
+  x *= 0x7feb352d;
+  x ^= x >> 15;
+  x *= 0x846ca68b;
+  x ^= x >> 16;
+  return x;
+}
+
+void
+test_main (void)
+{
+  size_t i, j;
+
+  for (i = 0; i < PAGE_COUNT; i++)
+    for (j = 0; j < WORD_COUNT; j++)
+      big_chunks[i][j] = expected_word (i, j);
+  msg ("wrote %d pages", PAGE_COUNT);
+
+  for (i = 0; i < PAGE_COUNT; i++)
+    for (j = 0; j < WORD_COUNT; j++)
+      if (big_chunks[i][j] != expected_word (i, j))
+        fail ("data is inconsistent in page %zu, word %zu", i, j);
+  msg ("read back %d pages", PAGE_COUNT);
+
+  for (i = PAGE_COUNT; i-- > 0; )
+    if (big_chunks[i][0] != expected_word (i, 0)
+        || big_chunks[i][WORD_COUNT - 1] != expected_word (i, WORD_COUNT - 1))
+      fail ("data is inconsistent in page %zu on the way back", i);
+  msg ("read back %d pages in reverse", PAGE_COUNT);
+}
@@ -0,0 +1,23 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected (IGNORE_EXIT_CODES => 1, [<<'EOF']);
+(swap-zswap) begin
+(swap-zswap) wrote 3072 pages
+(swap-zswap) read back 3072 pages
+(swap-zswap) read back 3072 pages in reverse
+(swap-zswap) end
+EOF
+
+our ($test);
+my (@output) = read_text_file ("$test.output");
+my ($stats) = grep (/^Zswap: /, @output);
+fail "missing \"Zswap:\" statistics: compressed swap cache is off\n"
+  if !defined $stats;
+my ($stores, $rejects) = $stats =~ /(\d+) stores \((\d+) incompressible/;
+my ($hits) = $stats =~ /(\d+) hits/;
+fail "no pages stored in the compressed swap cache\n" if !$stores;
+fail "no incompressible pages sent to the swap disk\n" if !$rejects;
+fail "no swap-ins served from the compressed swap cache\n" if !$hits;
+pass;
@@ -0,0 +1,37 @@
+/* Checks that executable text is shared through the text cache.
+   Runs child-text twice, one after the other.  Each run exits with
+   the frame that holds its code, and since the first run's text
+   frames stay cached after it exits, the second run must map the
+   same frame instead of reading the page again. */
+
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+/* Runs child-text to completion and returns its exit status. */
+static int
+run_child (void)
+{
+  pid_t child = fork ("child-text");
+
+  if (child == 0)
+    {
+      if (exec ("child-text") == -1)
+        fail ("failed to exec child-text");
+    }
+  return wait (child);
+}
+
+void
+test_main (void)
+{
+  int first, second;
+
+  first = run_child ();
+  CHECK (first > 0, "first run has its code in a frame");
+  second = run_child ();
+  if (second != first)
+    fail ("first run's code in frame %#x, second run's in %#x",
+          first, second);
+  msg ("second run maps the same code frame");
+}
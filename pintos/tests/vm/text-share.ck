@@ -0,0 +1,18 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected (IGNORE_EXIT_CODES => 1, [<<'EOF']);
+(text-share) begin
+(text-share) first run has its code in a frame
+(text-share) second run maps the same code frame
+(text-share) end
+EOF
+
+our ($test);
+my (@output) = read_text_file ("$test.output");
+my ($stats) = grep (/^Text cache: /, @output);
+fail "missing \"Text cache:\" statistics\n" if !defined $stats;
+my ($shared) = $stats =~ /(\d+) pages mapped from the cache/;
+fail "no page was mapped from the text cache\n" if !$shared;
+pass;
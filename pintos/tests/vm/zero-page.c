@@ -0,0 +1,66 @@
+/* Checks the shared zero page.  Reading untouched anonymous pages
+   maps them all to one read-only zero frame.  The first write to one
+   of them takes a copy-on-write fault and gives that page a zeroed
+   frame of its own, while the other pages stay on the zero frame. */
+
+#include <stdint.h>
+#include <string.h>
+#include <syscall.h>
+#include "tests/lib.h"
+#include "tests/main.h"
+
+#define PAGE_SIZE 4096
+#define PAGE_CNT 8
+#define WRITTEN 3
+
+static char buf[(PAGE_CNT + 1) * PAGE_SIZE];
+static struct pfstat before, after;
+
+void
+test_main (void)
+{
+  volatile char *pages = (char *) (((uintptr_t) buf + PAGE_SIZE - 1)
+                                   & ~(uintptr_t) (PAGE_SIZE - 1));
+  void *zero_pa;
+  char sum = 0;
+  bool same;
+  int i;
+
+  memset (&before, 0, sizeof before);
+  memset (&after, 0, sizeof after);
+
+  pfstat (&before);
+  for (i = 0; i < PAGE_CNT; i++)
+    sum |= pages[i * PAGE_SIZE + i * 13];
+  pfstat (&after);
+  CHECK (sum == 0, "untouched pages read as zeros");
+  CHECK (after.proc_count[FAULT_UNINIT_ANON]
+         - before.proc_count[FAULT_UNINIT_ANON] == PAGE_CNT,
+         "one fault per page read");
+
+  zero_pa = get_phys_addr ((void *) pages);
+  same = zero_pa != NULL;
+  for (i = 1; i < PAGE_CNT; i++)
+    same = same && get_phys_addr ((void *) (pages + i * PAGE_SIZE)) == zero_pa;
+  CHECK (same, "all pages map the same zero frame");
+
+  pfstat (&before);
+  pages[WRITTEN * PAGE_SIZE + 5] = 'w';
+  pfstat (&after);
+  CHECK (after.proc_count[FAULT_COW] - before.proc_count[FAULT_COW] == 1,
+         "first write takes one copy-on-write fault");
+  CHECK (get_phys_addr ((void *) (pages + WRITTEN * PAGE_SIZE)) != zero_pa,
+         "written page got its own frame");
+
+  same = true;
+  for (i = 0; i < PAGE_SIZE; i++)
+    same = same && pages[WRITTEN * PAGE_SIZE + i] == (i == 5 ? 'w' : 0);
+  CHECK (same, "written page is zero-filled around the write");
+
+  same = true;
+  for (i = 0; i < PAGE_CNT; i++)
+    if (i != WRITTEN)
+      same = same
+             && get_phys_addr ((void *) (pages + i * PAGE_SIZE)) == zero_pa;
+  CHECK (same, "other pages stay on the zero frame");
+}
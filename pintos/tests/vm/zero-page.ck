@@ -0,0 +1,16 @@
+# -*- perl -*-
+use strict;
+use warnings;
+use tests::tests;
+check_expected (IGNORE_EXIT_CODES => 1, [<<'EOF']);
+(zero-page) begin
+(zero-page) untouched pages read as zeros
+(zero-page) one fault per page read
+(zero-page) all pages map the same zero frame
+(zero-page) first write takes one copy-on-write fault
+(zero-page) written page got its own frame
+(zero-page) written page is zero-filled around the write
+(zero-page) other pages stay on the zero frame
+(zero-page) end
+EOF
+pass;
@@ -17,8 +17,10 @@
 #include "threads/io.h"
 #include "threads/loader.h"
 #include "threads/malloc.h"
+#include "threads/slab.h"
 #include "threads/mmu.h"
 #include "threads/palloc.h"
+#include "threads/profile.h"
 #include "threads/pte.h"
 #include "threads/thread.h"
 #ifdef USERPROG
@@ -31,6 +33,8 @@
 #include "tests/threads/tests.h"
 #ifdef VM
 #include "vm/vm.h"
+#include "vm/zswap.h"
+#include "vm/exectrace.h"
 #endif
 #ifdef FILESYS
 #include "devices/disk.h"
@@ -221,11 +225,29 @@ parse_options (char **argv) {
 			random_init (atoi (value));
 		else if (!strcmp (name, "-mlfqs"))
 			thread_mlfqs = true;
+		else if (!strcmp (name, "-tickless"))
+			timer_tickless = true;
+		else if (!strcmp (name, "-profile"))
+			profile_start (value != NULL ? atoi (value) : 1);
 #ifdef USERPROG
 		else if (!strcmp (name, "-ul"))
 			user_page_limit = atoi (value);
 		else if (!strcmp (name, "-threads-tests"))
 			thread_tests = true;
+#endif
+#ifdef VM
+		else if (!strcmp (name, "-fault-around"))
+			vm_fault_around_max = atoi (value);
+		else if (!strcmp (name, "-zswap"))
+			zswap_pool_pages = atoi (value);
+		else if (!strcmp (name, "-clean-watermark"))
+			vm_clean_watermark = atoi (value);
+		else if (!strcmp (name, "-ksm"))
+			vm_ksm_pages = atoi (value);
+		else if (!strcmp (name, "-ksm-sleep"))
+			vm_ksm_sleep_ms = atoi (value);
+		else if (!strcmp (name, "-exec-trace"))
+			exec_trace_pages = atoi (value);
 #endif
 		else
 			PANIC ("unknown option `%s' (use -h for help)", name);
@@ -326,8 +348,18 @@ usage (void) {
 			"  -f                 Format file system disk during startup.\n"
 			"  -rs=SEED           Set random number seed to SEED.\n"
 			"  -mlfqs             Use multi-level feedback queue scheduler.\n"
+			"  -tickless          Stop the periodic timer tick while idle.\n"
+			"  -profile[=N]       Sample the running code every N ticks (default 1).\n"
 #ifdef USERPROG
 			"  -ul=COUNT          Limit user memory to COUNT pages.\n"
+#endif
+#ifdef VM
+			"  -fault-around=N    Map up to N pages per file-backed fault (default 8).\n"
+			"  -zswap=N           Keep up to N pages of compressed swap in memory.\n"
+			"  -clean-watermark=N Keep N clean frames ahead of eviction (default 16).\n"
+			"  -ksm=N             Scan N frames per pass for identical pages.\n"
+			"  -ksm-sleep=MS      Sleep MS milliseconds between passes (default 20).\n"
+			"  -exec-trace=N      Record and prefetch the first N pages of each executable.\n"
 #endif
 			);
 	power_off ();
@@ -343,6 +375,7 @@ power_off (void) {
 #endif
 
 	print_stats ();
+	profile_dump ();
 
 	printf ("Powering off...\n");
 	outw (0x604, 0x2000);               /* Poweroff command for qemu */
@@ -354,6 +387,11 @@ static void
 print_stats (void) {
 	timer_print_stats ();
 	thread_print_stats ();
+	palloc_print_stats ();
+	kmem_cache_print_stats ();
+#ifdef LOCK_PROFILE
+	synch_print_stats ();
+#endif
 #ifdef FILESYS
 	disk_print_stats ();
 #endif
@@ -362,4 +400,7 @@ print_stats (void) {
 #ifdef USERPROG
 	exception_print_stats ();
 #endif
+#ifdef VM
+	vm_print_stats ();
+#endif
 }
@@ -329,6 +329,10 @@ intr_handler (struct intr_frame *frame) {
 
 		in_external_intr = true;
 		yield_on_return = false;
+
+		/* idle 쓰레드가 tickless로 잠들어 있었다면, 핸들러가 최신 ticks를
+		   보도록 그동안 지나간 틱을 먼저 따라잡습니다. */
+		timer_idle_exit (frame->vec_no == 0x20);
 	}
 
 	/* 인터럽트의 핸들러를 호출합니다. */
@@ -38,6 +38,7 @@ struct desc {
 	size_t blocks_per_arena;    /* arena당 블록 수. */
 	struct list free_list;      /* 자유 블록들의 목록. */
 	struct lock lock;           /* 락. */
+	char name[16];              /* 락 프로파일러에 표시할 이름. */
 };
 
 /* arena 손상 감지를 위한 매직 넘버. */
@@ -75,6 +76,8 @@ malloc_init (void) {
 		d->blocks_per_arena = (PGSIZE - sizeof (struct arena)) / block_size;
 		list_init (&d->free_list);
 		lock_init (&d->lock);
+		snprintf (d->name, sizeof d->name, "malloc%zu", block_size);
+		lock_set_name (&d->lock, d->name);
 	}
 }
 
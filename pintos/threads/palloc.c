@@ -2,14 +2,15 @@
 #include <bitmap.h>
 #include <debug.h>
 #include <inttypes.h>
+#include <list.h>
 #include <round.h>
 #include <stddef.h>
 #include <stdint.h>
 #include <stdio.h>
 #include <string.h>
 #include "threads/init.h"
+#include "threads/interrupt.h"
 #include "threads/loader.h"
-#include "threads/synch.h"
 #include "threads/vaddr.h"
 
 /* 페이지 할당자. 페이지 크기(또는 페이지 배수) 단위로 메모리를 할당합니다.
@@ -21,13 +22,46 @@
    메모리를 가져야 한다는 것입니다.
 
    기본적으로 시스템 RAM의 절반은 커널 풀에, 절반은 사용자 풀에 할당됩니다.
-   이는 커널 풀에게는 엄청난 과잉이어야 하지만, 데모 목적으로는 괜찮습니다. */
+   이는 커널 풀에게는 엄청난 과잉이어야 하지만, 데모 목적으로는 괜찮습니다.
+
+   각 풀은 이진 버디 할당자입니다. 빈 페이지들은 2^order 페이지 크기로
+   정렬된 블록으로 묶여 order별 free list에 들어갑니다. 할당은 필요한
+   order 이상의 가장 작은 블록을 반으로 쪼개 가며 얻고, 해제는 짝(buddy)
+   블록이 비어있으면 합쳐 가며 돌려놓으므로 둘 다 O(log n)입니다.
+   2의 거듭제곱이 아닌 PAGE_CNT는 올림한 크기의 블록을 얻은 뒤 남는
+   꼬리 페이지들을 바로 돌려놓습니다.
+
+   빈 블록의 list_elem은 페이지마다 하나씩 비트맵 옆에 잡아둔 배열에
+   둡니다. 빈 페이지 자체에 쓰지 않는 이유는 paging_init() 전에는 부팅
+   페이지 테이블이 물리 메모리의 앞부분만 매핑하고 있기 때문입니다.
+
+   free list는 락이 아니라 인터럽트를 꺼서 보호합니다. do_schedule()이
+   죽은 쓰레드의 페이지를 palloc_free_page()로 돌려주는데, 이때는
+   잠들 수 없으므로 잠드는 락을 쓸 수 없습니다. 버디 연산은 O(log n)
+   이라 인터럽트를 끄는 시간도 짧습니다. */
+
+/* 풀마다 미리 0으로 채워 둘 페이지 수. */
+#define ZEROED_RESERVE 32
+
+/* order_map에서 빈 블록의 첫 페이지가 아님을 뜻하는 값. */
+#define ORDER_NONE 0xff
 
 /* 메모리 풀 */
 struct pool {
-	struct lock lock;               /* 상호 배제 */
 	struct bitmap *used_map;        /* 사용 중인 페이지들의 비트맵 */
+	uint8_t *order_map;             /* 빈 블록의 첫 페이지면 그 order, 아니면 ORDER_NONE */
+	struct list_elem *block_elems;  /* 페이지별 free list 요소 */
+	struct list free_lists[BUDDY_ORDERS];   /* order별 빈 블록 목록 */
+	size_t free_blocks[BUDDY_ORDERS];       /* order별 빈 블록 수 */
+	size_t free_pages;              /* 빈 페이지 수 */
 	uint8_t *base;                  /* 풀의 기준 주소 */
+
+	/* 유휴 쓰레드가 0으로 채워 둔 페이지들. 버디 할당자 입장에서는 이미
+	   할당된 페이지입니다. 인터럽트를 끄고 접근합니다. */
+	void *zeroed[ZEROED_RESERVE];
+	size_t zeroed_cnt;
+	uint64_t zero_hits;             /* 예비 페이지로 처리한 PAL_ZERO 요청 */
+	uint64_t zero_misses;           /* 직접 memset 한 PAL_ZERO 요청 */
 };
 
 /* 두 개의 풀: 커널 데이터용 하나, 사용자 페이지용 하나 */
@@ -36,9 +70,14 @@ static struct pool kernel_pool, user_pool;
 /* 사용자 풀에 넣을 최대 페이지 수 */
 size_t user_page_limit = SIZE_MAX;
 static void
-init_pool (struct pool *p, void **bm_base, uint64_t start, uint64_t end);
+init_pool (struct pool *p, void **bm_base,
+		uint64_t start, uint64_t end);
 
 static bool page_from_pool (const struct pool *, void *page);
+static size_t buddy_alloc (struct pool *, size_t page_cnt);
+static void buddy_free_range (struct pool *, size_t page_idx, size_t page_cnt);
+static void *zeroed_pop (struct pool *);
+static bool zeroed_drain (struct pool *);
 
 /* multiboot info */
 struct multiboot_info {
@@ -155,8 +194,8 @@ populate_pools (struct area *base_mem, struct area *ext_mem) {
 						break;
 					}
 					// 커널 풀 생성
-					init_pool (&kernel_pool,
-							&free_start, region_start, start + rem * PGSIZE);
+					init_pool (&kernel_pool, &free_start,
+							region_start, start + rem * PGSIZE);
                             // 다음 상태로 전환
 					if (rem == size_in_pg) {
 						rem = user_pages;
@@ -220,12 +259,12 @@ split:
 			page_idx = pg_no (start) - pg_no (pool->base);
 			if ((uint64_t) pool_end < end) {
 				page_cnt = ((uint64_t) pool_end - start) / PGSIZE;
-				bitmap_set_multiple (pool->used_map, page_idx, page_cnt, false);
+				buddy_free_range (pool, page_idx, page_cnt);
 				start = (uint64_t) pool_end;
 				goto split;
 			} else {
 				page_cnt = ((uint64_t) end - start) / PGSIZE;
-				bitmap_set_multiple (pool->used_map, page_idx, page_cnt, false);
+				buddy_free_range (pool, page_idx, page_cnt);
 			}
 		}
 	}
@@ -260,9 +299,30 @@ void *
 palloc_get_multiple (enum palloc_flags flags, size_t page_cnt) {
 	struct pool *pool = flags & PAL_USER ? &user_pool : &kernel_pool;
 
-	lock_acquire (&pool->lock);
-	size_t page_idx = bitmap_scan_and_flip (pool->used_map, 0, page_cnt, false);
-	lock_release (&pool->lock);
+	if (page_cnt == 0)
+		return NULL;
+
+	/* 0으로 채운 한 페이지는 유휴 쓰레드가 준비해 둔 것을 먼저 씁니다.
+	   통계도 예비 페이지와 함께 인터럽트를 끈 채 갱신합니다. */
+	if (page_cnt == 1 && (flags & PAL_ZERO)) {
+		enum intr_level old_level = intr_disable ();
+		void *page = zeroed_pop (pool);
+
+		if (page != NULL)
+			pool->zero_hits++;
+		else
+			pool->zero_misses++;
+		intr_set_level (old_level);
+		if (page != NULL)
+			return page;
+	}
+
+	enum intr_level old_level = intr_disable ();
+	size_t page_idx = buddy_alloc (pool, page_cnt);
+	/* 메모리가 모자라면 예비 페이지를 돌려놓고 한 번 더 시도합니다. */
+	if (page_idx == BITMAP_ERROR && zeroed_drain (pool))
+		page_idx = buddy_alloc (pool, page_cnt);
+	intr_set_level (old_level);
 	void *pages;
 
 	if (page_idx != BITMAP_ERROR)
@@ -297,6 +357,7 @@ void
 palloc_free_multiple (void *pages, size_t page_cnt) {
 	struct pool *pool;
 	size_t page_idx;
+	enum intr_level old_level;
 
 	ASSERT (pg_ofs (pages) == 0);
 	if (pages == NULL || page_cnt == 0)
@@ -314,8 +375,10 @@ palloc_free_multiple (void *pages, size_t page_cnt) {
 #ifndef NDEBUG
 	memset (pages, 0xcc, PGSIZE * page_cnt);
 #endif
+	old_level = intr_disable ();
 	ASSERT (bitmap_all (pool->used_map, page_idx, page_cnt));
-	bitmap_set_multiple (pool->used_map, page_idx, page_cnt, false);
+	buddy_free_range (pool, page_idx, page_cnt);
+	intr_set_level (old_level);
 }
 
 /* PAGE의 페이지를 해제합니다. */
@@ -324,25 +387,275 @@ palloc_free_page (void *page) {
 	palloc_free_multiple (page, 1);
 }
 
-/* 풀 P를 START에서 시작하여 END에서 끝나도록 초기화합니다 */
+/* 풀 P를 START에서 시작하여 END에서 끝나도록 초기화합니다. */
 static void
-init_pool (struct pool *p, void **bm_base, uint64_t start, uint64_t end) {
-    /* 풀의 used_map을 기준점에 둡니다.
-       비트맵에 필요한 공간을 계산하고
+init_pool (struct pool *p, void **bm_base,
+		uint64_t start, uint64_t end) {
+    /* 풀의 used_map과 order_map을 기준점에 둡니다.
+       필요한 공간을 계산하고
        풀의 크기에서 빼냅니다. */
 	uint64_t pgcnt = (end - start) / PGSIZE;
-	size_t bm_pages = DIV_ROUND_UP (bitmap_buf_size (pgcnt), PGSIZE) * PGSIZE;
+	size_t bm_size = ROUND_UP (bitmap_buf_size (pgcnt), sizeof (struct list_elem));
+	size_t elems_size = pgcnt * sizeof (struct list_elem);
+	size_t bm_pages = DIV_ROUND_UP (bm_size + elems_size + pgcnt, PGSIZE) * PGSIZE;
 
-	lock_init(&p->lock);
-	p->used_map = bitmap_create_in_buf (pgcnt, *bm_base, bm_pages);
+	p->used_map = bitmap_create_in_buf (pgcnt, *bm_base, bm_size);
+	p->block_elems = (struct list_elem *) ((uint8_t *) *bm_base + bm_size);
+	p->order_map = (uint8_t *) *bm_base + bm_size + elems_size;
 	p->base = (void *) start;
+	for (int order = 0; order < BUDDY_ORDERS; order++) {
+		list_init (&p->free_lists[order]);
+		p->free_blocks[order] = 0;
+	}
+	p->free_pages = 0;
+	p->zeroed_cnt = 0;
+	p->zero_hits = p->zero_misses = 0;
 
 	// 모든 것을 사용 불가능으로 표시합니다.
 	bitmap_set_all(p->used_map, true);
+	memset (p->order_map, ORDER_NONE, pgcnt);
 
 	*bm_base += bm_pages;
 }
 
+/* P의 PAGE_IDX 페이지에 해당하는 free list 요소를 반환합니다. */
+static struct list_elem *
+block_elem (struct pool *p, size_t page_idx) {
+	return &p->block_elems[page_idx];
+}
+
+/* 블록 요소 E에 해당하는 페이지의 번호를 반환합니다. */
+static size_t
+block_idx (struct pool *p, struct list_elem *e) {
+	return e - p->block_elems;
+}
+
+/* PAGE_CNT 페이지를 담을 수 있는 가장 작은 order를 반환합니다. */
+static int
+order_for (size_t page_cnt) {
+	int order = 0;
+
+	while (((size_t) 1 << order) < page_cnt)
+		order++;
+	return order;
+}
+
+/* PAGE_IDX에서 시작하는 2^ORDER 페이지 블록을 free list에 넣습니다. */
+static void
+push_block (struct pool *p, size_t page_idx, int order) {
+	p->order_map[page_idx] = order;
+	list_push_front (&p->free_lists[order], block_elem (p, page_idx));
+	p->free_blocks[order]++;
+}
+
+/* PAGE_IDX에서 시작하는 2^ORDER 페이지 블록을 free list에서 뺍니다. */
+static void
+remove_block (struct pool *p, size_t page_idx, int order) {
+	ASSERT (p->order_map[page_idx] == order);
+
+	p->order_map[page_idx] = ORDER_NONE;
+	list_remove (block_elem (p, page_idx));
+	p->free_blocks[order]--;
+}
+
+/* 연속된 PAGE_CNT 페이지를 할당하고 첫 페이지 번호를 반환합니다.
+   빈 블록이 없으면 BITMAP_ERROR를 반환합니다. 인터럽트를 끄고 호출해야
+   합니다. */
+static size_t
+buddy_alloc (struct pool *p, size_t page_cnt) {
+	int want = order_for (page_cnt);
+	int order = want;
+	size_t page_idx;
+
+	if (want >= BUDDY_ORDERS)
+		return BITMAP_ERROR;
+	while (order < BUDDY_ORDERS && list_empty (&p->free_lists[order]))
+		order++;
+	if (order == BUDDY_ORDERS)
+		return BITMAP_ERROR;
+
+	page_idx = block_idx (p, list_front (&p->free_lists[order]));
+	remove_block (p, page_idx, order);
+
+	/* 필요한 크기가 될 때까지 반으로 쪼개고 뒤쪽 절반을 돌려놓습니다. */
+	while (order > want) {
+		order--;
+		push_block (p, page_idx + ((size_t) 1 << order), order);
+	}
+
+	ASSERT (!bitmap_contains (p->used_map, page_idx, (size_t) 1 << want, true));
+	bitmap_set_multiple (p->used_map, page_idx, page_cnt, true);
+	p->free_pages -= (size_t) 1 << want;
+
+	/* 2의 거듭제곱이 아니면 쓰지 않는 꼬리 페이지를 돌려놓습니다. */
+	buddy_free_range (p, page_idx + page_cnt, ((size_t) 1 << want) - page_cnt);
+	return page_idx;
+}
+
+/* PAGE_IDX에서 시작하는 2^ORDER 페이지 블록을 해제하고, 짝 블록이
+   같은 크기로 비어있는 동안 계속 합칩니다. */
+static void
+buddy_free_block (struct pool *p, size_t page_idx, int order) {
+	size_t pgcnt = bitmap_size (p->used_map);
+
+	bitmap_set_multiple (p->used_map, page_idx, (size_t) 1 << order, false);
+	p->free_pages += (size_t) 1 << order;
+
+	while (order < BUDDY_ORDERS - 1) {
+		size_t buddy = page_idx ^ ((size_t) 1 << order);
+
+		if (buddy >= pgcnt || p->order_map[buddy] != order)
+			break;
+		remove_block (p, buddy, order);
+		page_idx &= ~((size_t) 1 << order);
+		order++;
+	}
+	push_block (p, page_idx, order);
+}
+
+/* PAGE_IDX에서 시작하는 PAGE_CNT 페이지를 해제합니다. 범위를 정렬된
+   가장 큰 블록들로 나누어 각각 buddy_free_block()으로 돌려놓습니다.
+   인터럽트를 끄고 호출하거나, 부팅 중 단일 쓰레드일 때 호출해야 합니다. */
+static void
+buddy_free_range (struct pool *p, size_t page_idx, size_t page_cnt) {
+	while (page_cnt > 0) {
+		int order = 0;
+
+		while (order + 1 < BUDDY_ORDERS
+				&& (page_idx & (((size_t) 2 << order) - 1)) == 0
+				&& ((size_t) 2 << order) <= page_cnt)
+			order++;
+		buddy_free_block (p, page_idx, order);
+		page_idx += (size_t) 1 << order;
+		page_cnt -= (size_t) 1 << order;
+	}
+}
+
+/* P의 0으로 채운 예비 페이지를 하나 꺼내 반환합니다. 없으면 NULL을
+   반환합니다. */
+static void *
+zeroed_pop (struct pool *p) {
+	void *page = NULL;
+	enum intr_level old_level = intr_disable ();
+
+	if (p->zeroed_cnt > 0)
+		page = p->zeroed[--p->zeroed_cnt];
+	intr_set_level (old_level);
+	return page;
+}
+
+/* P의 예비 페이지를 모두 버디 할당자에 돌려놓습니다. 돌려놓은 것이
+   있으면 true를 반환합니다. 인터럽트를 끄고 호출해야 합니다. */
+static bool
+zeroed_drain (struct pool *p) {
+	bool drained = false;
+	void *page;
+
+	while ((page = zeroed_pop (p)) != NULL) {
+		buddy_free_range (p, pg_no (page) - pg_no (p->base), 1);
+		drained = true;
+	}
+	return drained;
+}
+
+/* P의 예비 페이지를 ZEROED_RESERVE 개까지 채웁니다. 남은 페이지가
+   예비분의 두 배보다 적으면 채우지 않습니다. 유휴 쓰레드는
+   락을 가져서는 안 되므로 여기서도 인터럽트만 끄고 할당합니다. */
+static void
+zeroed_refill (struct pool *p) {
+	/* 예비 페이지를 넣는 것은 유휴 쓰레드뿐이므로, 한 번 확인한
+	   zeroed_cnt 는 그 사이 줄어들 수만 있습니다. */
+	while (p->zeroed_cnt < ZEROED_RESERVE) {
+		size_t page_idx = BITMAP_ERROR;
+		enum intr_level old_level = intr_disable ();
+
+		if (p->free_pages >= 2 * ZEROED_RESERVE)
+			page_idx = buddy_alloc (p, 1);
+		intr_set_level (old_level);
+		if (page_idx == BITMAP_ERROR)
+			return;
+
+		void *page = p->base + PGSIZE * page_idx;
+		memset (page, 0, PGSIZE);
+
+		old_level = intr_disable ();
+		p->zeroed[p->zeroed_cnt++] = page;
+		intr_set_level (old_level);
+	}
+}
+
+/* 실행할 쓰레드가 없을 때 idle()이 호출합니다. 두 풀의 0으로 채운
+   예비 페이지를 채웁니다. */
+void
+palloc_refill_zeroed (void) {
+	ASSERT (intr_get_level () == INTR_ON);
+
+	zeroed_refill (&user_pool);
+	zeroed_refill (&kernel_pool);
+}
+
+/* 풀 P의 통계를 ST에 복사합니다. */
+static void
+get_pool_stats (struct pool *p, struct palloc_stats *st) {
+	enum intr_level old_level = intr_disable ();
+
+	st->free_pages = p->free_pages;
+	memcpy (st->free_blocks, p->free_blocks, sizeof st->free_blocks);
+	st->zeroed_cnt = p->zeroed_cnt;
+	st->zero_hits = p->zero_hits;
+	st->zero_misses = p->zero_misses;
+	intr_set_level (old_level);
+}
+
+/* FLAGS에 PAL_USER가 설정되면 사용자 풀의, 그렇지 않으면 커널 풀의
+   통계를 ST에 복사합니다. */
+void
+palloc_get_stats (enum palloc_flags flags, struct palloc_stats *st) {
+	get_pool_stats (flags & PAL_USER ? &user_pool : &kernel_pool, st);
+}
+
+/* 풀 POOL의 단편화 정도를 출력합니다. */
+static void
+print_pool_stats (struct pool *pool, const char *name) {
+	struct palloc_stats st;
+	size_t blocks = 0;
+	int largest = -1;
+
+	/* printf()는 잠들 수 있으므로 인터럽트를 끈 채 숫자만 복사해 둡니다. */
+	get_pool_stats (pool, &st);
+
+	for (int order = 0; order < BUDDY_ORDERS; order++) {
+		blocks += st.free_blocks[order];
+		if (st.free_blocks[order] > 0)
+			largest = order;
+	}
+
+	/* 빈 페이지 중 가장 큰 블록에 들어있지 않은 비율. 0이면 단편화가
+	   없고, 100에 가까울수록 빈 페이지가 잘게 흩어져 있습니다. */
+	size_t largest_pages = largest >= 0 ? (size_t) 1 << largest : 0;
+	size_t frag = st.free_pages > 0
+		? 100 - largest_pages * 100 / st.free_pages : 0;
+
+	printf ("Palloc: %s: %zu free pages in %zu blocks, largest %zu pages, "
+			"%zu%% fragmented\n",
+			name, st.free_pages, blocks, largest_pages, frag);
+	printf ("Palloc: %s: %zu zeroed pages reserved, PAL_ZERO %llu hits, "
+			"%llu misses\n", name, st.zeroed_cnt,
+			(unsigned long long) st.zero_hits,
+			(unsigned long long) st.zero_misses);
+	printf ("Palloc: %s: free blocks by order:", name);
+	for (int order = 0; order <= largest; order++)
+		printf (" %zu", st.free_blocks[order]);
+	printf ("\n");
+}
+
+/* 두 풀의 단편화 보고서를 출력합니다. */
+void
+palloc_print_stats (void) {
+	print_pool_stats (&kernel_pool, "kernel_pool");
+	print_pool_stats (&user_pool, "user_pool");
+}
+
 /* PAGE가 POOL에서 할당되었으면 true를, 그렇지 않으면 false를 반환합니다. */
 static bool
 page_from_pool (const struct pool *pool, void *page) {
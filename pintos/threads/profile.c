@@ -0,0 +1,136 @@
+#include "threads/profile.h"
+#include <debug.h>
+#include <stdint.h>
+#include <stdio.h>
+#include "devices/serial.h"
+#include "threads/thread.h"
+#include "threads/vaddr.h"
+
+/* 보관할 샘플 수. 가득 차면 가장 오래된 샘플부터 덮어씁니다. */
+#define PROFILE_SAMPLES 2048
+
+/* 샘플마다 기록할 커널 호출자 수. */
+#define PROFILE_DEPTH 6
+
+/* 출력 형식의 버전. utils/pintos-prof 와 맞춰야 합니다. */
+#define PROFILE_VERSION 1
+
+/* 샘플 하나. */
+struct profile_sample {
+	uint64_t rip;                       /* 인터럽트된 명령어 주소 */
+	int32_t tid;                        /* 실행 중이던 쓰레드 */
+	uint8_t user;                       /* 사용자 모드였으면 1 */
+	uint8_t depth;                      /* callers[]에 기록된 수 */
+	uint64_t callers[PROFILE_DEPTH];    /* 커널 리턴 주소, 가까운 것부터 */
+};
+
+/* 샘플 간격(틱). 0이면 프로파일러가 꺼져 있습니다. */
+int profile_interval;
+
+/* 링 버퍼. 부팅할 때 BSS로 잡아두므로 인터럽트 핸들러에서 할당하지
+   않습니다. */
+static struct profile_sample samples[PROFILE_SAMPLES];
+static uint64_t sample_cnt;            /* 지금까지 기록한 샘플 수 */
+static int countdown;                  /* 다음 샘플까지 남은 틱 */
+
+/* INTERVAL 틱마다 샘플을 기록하기 시작합니다. */
+void
+profile_start (int interval) {
+	if (interval <= 0)
+		PANIC ("-profile interval must be positive");
+	profile_interval = interval;
+	countdown = interval;
+}
+
+/* 인터럽트된 커널 코드의 프레임 포인터 체인을 따라가며 리턴 주소를
+   S->callers 에 기록합니다. 커널은 -fno-omit-frame-pointer 로
+   빌드되므로 rbp 가 체인을 이룹니다. 체인이 현재 쓰레드의 커널
+   스택 페이지를 벗어나면 멈춥니다. */
+static void
+walk_frames (struct profile_sample *s, uint64_t rbp) {
+	uint64_t stack = (uint64_t) thread_current ();
+
+	while (s->depth < PROFILE_DEPTH
+			&& (rbp & 7) == 0
+			&& rbp >= stack && rbp + 16 <= stack + PGSIZE) {
+		uint64_t *fp = (uint64_t *) rbp;
+
+		s->callers[s->depth++] = fp[1];
+		if (fp[0] <= rbp)
+			break;
+		rbp = fp[0];
+	}
+}
+
+/* 타이머 인터럽트에서 호출됩니다. 간격이 되면 F가 가리키는 인터럽트된
+   위치를 링 버퍼에 기록합니다. */
+void
+profile_sample (struct intr_frame *f) {
+	struct profile_sample *s;
+
+	ASSERT (intr_context ());
+
+	if (--countdown > 0)
+		return;
+	countdown = profile_interval;
+
+	s = &samples[sample_cnt++ % PROFILE_SAMPLES];
+	s->rip = f->rip;
+	s->tid = thread_current ()->tid;
+	s->user = (f->cs & 3) != 0;
+	s->depth = 0;
+
+	/* 사용자 스택은 믿을 수 없으므로 커널 코드만 거슬러 올라갑니다. */
+	if (!s->user)
+		walk_frames (s, f->R.rbp);
+}
+
+/* X의 하위 BYTES 바이트를 리틀 엔디언으로 시리얼에 씁니다. */
+static void
+put_le (uint64_t x, int bytes) {
+	for (int i = 0; i < bytes; i++)
+		serial_putc ((x >> (8 * i)) & 0xff);
+}
+
+/* 모은 샘플을 시리얼 포트로 내보냅니다. vga 에는 쓰지 않습니다.
+
+   형식 (리틀 엔디언):
+     "\nPROF"  u32 version  u32 count  u32 dropped  u32 interval
+   이후 오래된 것부터 count 개의 샘플:
+     u64 rip  i32 tid  u8 user  u8 depth  u64 callers[depth] */
+void
+profile_dump (void) {
+	uint64_t first, kept;
+	enum intr_level old_level;
+
+	if (profile_interval == 0)
+		return;
+
+	old_level = intr_disable ();
+	kept = sample_cnt < PROFILE_SAMPLES ? sample_cnt : PROFILE_SAMPLES;
+	first = sample_cnt - kept;
+
+	printf ("Profile: %llu samples, %llu dropped\n",
+			(unsigned long long) kept, (unsigned long long) first);
+
+	for (const char *p = "\nPROF"; *p != '\0'; p++)
+		serial_putc (*p);
+	put_le (PROFILE_VERSION, 4);
+	put_le (kept, 4);
+	put_le (first, 4);
+	put_le (profile_interval, 4);
+
+	for (uint64_t i = first; i < sample_cnt; i++) {
+		struct profile_sample *s = &samples[i % PROFILE_SAMPLES];
+
+		put_le (s->rip, 8);
+		put_le ((uint32_t) s->tid, 4);
+		put_le (s->user, 1);
+		put_le (s->depth, 1);
+		for (int d = 0; d < s->depth; d++)
+			put_le (s->callers[d], 8);
+	}
+	serial_putc ('\n');
+	serial_flush ();
+	intr_set_level (old_level);
+}
@@ -0,0 +1,259 @@
+#include "threads/slab.h"
+#include <debug.h>
+#include <round.h>
+#include <stdio.h>
+#include <string.h>
+#include "threads/interrupt.h"
+#include "threads/palloc.h"
+#include "threads/vaddr.h"
+
+/* 각 slab 은 커널 풀의 한 페이지입니다. 페이지 맨 앞에 struct slab 헤더와
+   빈 칸 번호의 스택이 있고, 그 뒤로 객체들이 빈틈없이 놓입니다.
+   빈 칸 목록을 객체 안이 아닌 헤더에 두므로, 생성자가 초기화한 상태는
+   해제된 뒤에도 그대로 남습니다.
+
+   +--------+------------------+-----+-----+-----+----
+   | slab   | free[] (uint16)  | obj | obj | obj | ...
+   +--------+------------------+-----+-----+-----+----
+
+   객체의 slab 은 pg_round_down()으로 찾습니다. */
+
+/* slab 손상 감지를 위한 매직 넘버. */
+#define SLAB_MAGIC 0x51ab51ab
+
+/* Slab. */
+struct slab {
+	unsigned magic;                 /* 항상 SLAB_MAGIC */
+	struct kmem_cache *cache;       /* 소유하는 캐시 */
+	struct list_elem elem;          /* partial 또는 full 목록의 요소 */
+	uint16_t free_cnt;              /* 빈 칸 수 */
+	uint16_t free[];                /* 빈 칸 번호의 스택 */
+};
+
+/* 통계를 출력할 모든 캐시의 목록. */
+static struct list cache_list = LIST_INITIALIZER (cache_list);
+
+/* SIZE 바이트 객체의 캐시 C를 NAME으로 초기화합니다. CTOR가 NULL이
+   아니면 slab 을 새로 만들 때 각 객체에 한 번씩 호출하며, 객체는
+   생성된 상태로 kmem_cache_free()에 돌려주어야 합니다.
+   메모리를 할당하지 않으므로 palloc_init() 전에 호출해도 됩니다. */
+void
+kmem_cache_init (struct kmem_cache *c, const char *name, size_t size,
+		void (*ctor) (void *)) {
+	size_t n;
+
+	ASSERT (c != NULL);
+	ASSERT (size > 0);
+
+	c->name = name;
+	c->obj_size = ROUND_UP (size, sizeof (void *));
+	c->ctor = ctor;
+
+	/* 헤더와 빈 칸 스택까지 합쳐 한 페이지에 들어가는 최대 객체 수. */
+	for (n = PGSIZE / c->obj_size; n > 0; n--) {
+		size_t ofs = ROUND_UP (sizeof (struct slab) + n * sizeof (uint16_t),
+				sizeof (void *));
+		if (ofs + n * c->obj_size <= PGSIZE) {
+			c->obj_ofs = ofs;
+			break;
+		}
+	}
+	ASSERT (n > 0);
+	c->objs_per_slab = n;
+
+	lock_init (&c->lock);
+	list_init (&c->partial);
+	c->partial_cnt = 0;
+	list_init (&c->full);
+	c->mag.cnt = 0;
+	c->allocs = c->frees = c->mag_hits = c->slabs = 0;
+
+	enum intr_level old_level = intr_disable ();
+	list_push_back (&cache_list, &c->elem);
+	intr_set_level (old_level);
+}
+
+/* OBJ가 들어있는 slab 을 반환합니다. */
+static struct slab *
+obj_to_slab (struct kmem_cache *c UNUSED, void *obj) {
+	struct slab *s = pg_round_down (obj);
+
+	ASSERT (s->magic == SLAB_MAGIC);
+	ASSERT (s->cache == c);
+	ASSERT (((uint8_t *) obj - (uint8_t *) s - c->obj_ofs) % c->obj_size == 0);
+	return s;
+}
+
+/* slab S의 IDX번째 객체를 반환합니다. */
+static void *
+slab_obj (struct kmem_cache *c, struct slab *s, size_t idx) {
+	return (uint8_t *) s + c->obj_ofs + idx * c->obj_size;
+}
+
+/* 새 slab 을 만들어 C의 partial 목록에 넣습니다.
+   C의 락을 잡고 호출해야 합니다. */
+static struct slab *
+slab_create (struct kmem_cache *c) {
+	struct slab *s = palloc_get_page (0);
+
+	if (s == NULL)
+		return NULL;
+	s->magic = SLAB_MAGIC;
+	s->cache = c;
+	s->free_cnt = c->objs_per_slab;
+	for (size_t i = 0; i < c->objs_per_slab; i++) {
+		/* 낮은 번호부터 나가도록 스택에 거꾸로 쌓습니다. */
+		s->free[i] = c->objs_per_slab - 1 - i;
+		if (c->ctor != NULL)
+			c->ctor (slab_obj (c, s, i));
+	}
+	list_push_front (&c->partial, &s->elem);
+	c->partial_cnt++;
+	c->slabs++;
+	return s;
+}
+
+/* C의 slab 에서 객체 하나를 꺼냅니다. C의 락을 잡고 호출해야 합니다. */
+static void *
+slab_alloc (struct kmem_cache *c) {
+	struct slab *s;
+
+	if (list_empty (&c->partial)) {
+		if (slab_create (c) == NULL)
+			return NULL;
+	}
+	s = list_entry (list_front (&c->partial), struct slab, elem);
+	void *obj = slab_obj (c, s, s->free[--s->free_cnt]);
+	if (s->free_cnt == 0) {
+		list_remove (&s->elem);
+		list_push_front (&c->full, &s->elem);
+		c->partial_cnt--;
+	}
+	return obj;
+}
+
+/* OBJ를 slab 에 돌려놓습니다. slab 이 통째로 비고 다른 partial slab 이
+   있으면 페이지를 반납합니다. C의 락을 잡고 호출해야 합니다. */
+static void
+slab_free (struct kmem_cache *c, void *obj) {
+	struct slab *s = obj_to_slab (c, obj);
+	size_t idx = ((uint8_t *) obj - (uint8_t *) s - c->obj_ofs) / c->obj_size;
+
+	ASSERT (s->free_cnt < c->objs_per_slab);
+
+	if (s->free_cnt == 0) {
+		list_remove (&s->elem);
+		list_push_front (&c->partial, &s->elem);
+		c->partial_cnt++;
+	}
+	s->free[s->free_cnt++] = idx;
+
+	if (s->free_cnt == c->objs_per_slab && c->partial_cnt > 1) {
+		list_remove (&s->elem);
+		c->partial_cnt--;
+		s->magic = 0;
+		palloc_free_page (s);
+		c->slabs--;
+	}
+}
+
+/* C에서 객체 하나를 할당해 반환합니다. 메모리가 없으면 NULL을
+   반환합니다. magazine 에 객체가 있으면 락 없이 끝납니다. */
+void *
+kmem_cache_alloc (struct kmem_cache *c) {
+	enum intr_level old_level;
+	struct kmem_magazine *m;
+	void *obj = NULL;
+
+	ASSERT (c != NULL);
+	ASSERT (!intr_context ());
+
+	old_level = intr_disable ();
+	m = &c->mag;
+	if (m->cnt > 0) {
+		obj = m->objs[--m->cnt];
+		c->mag_hits++;
+	}
+	c->allocs++;
+	intr_set_level (old_level);
+
+	if (obj == NULL) {
+		lock_acquire (&c->lock);
+		obj = slab_alloc (c);
+		lock_release (&c->lock);
+		if (obj == NULL) {
+			old_level = intr_disable ();
+			c->allocs--;
+			intr_set_level (old_level);
+		}
+	}
+	return obj;
+}
+
+/* kmem_cache_alloc()과 같지만 객체를 0으로 채워 반환합니다.
+   calloc()으로 할당하던 곳을 옮길 때 씁니다. */
+void *
+kmem_cache_zalloc (struct kmem_cache *c) {
+	void *obj = kmem_cache_alloc (c);
+
+	if (obj != NULL)
+		memset (obj, 0, c->obj_size);
+	return obj;
+}
+
+/* C에서 할당한 OBJ를 해제합니다. OBJ가 NULL이면 아무 일도 하지
+   않습니다. magazine 이 가득 찼으면 절반을 slab 에
+   돌려놓습니다. */
+void
+kmem_cache_free (struct kmem_cache *c, void *obj) {
+	enum intr_level old_level;
+	struct kmem_magazine *m;
+	void *flush[KMEM_MAG_SIZE / 2];
+	int flush_cnt = 0;
+
+	ASSERT (c != NULL);
+	ASSERT (!intr_context ());
+
+	if (obj == NULL)
+		return;
+	obj_to_slab (c, obj);
+
+	old_level = intr_disable ();
+	m = &c->mag;
+	if (m->cnt == KMEM_MAG_SIZE) {
+		flush_cnt = KMEM_MAG_SIZE / 2;
+		m->cnt -= flush_cnt;
+		memcpy (flush, &m->objs[m->cnt], sizeof flush);
+	}
+	m->objs[m->cnt++] = obj;
+	c->frees++;
+	intr_set_level (old_level);
+
+	if (flush_cnt > 0) {
+		lock_acquire (&c->lock);
+		for (int i = 0; i < flush_cnt; i++)
+			slab_free (c, flush[i]);
+		lock_release (&c->lock);
+	}
+}
+
+/* 모든 캐시의 통계를 출력합니다. */
+void
+kmem_cache_print_stats (void) {
+	struct list_elem *e;
+
+	for (e = list_begin (&cache_list); e != list_end (&cache_list);
+			e = list_next (e)) {
+		struct kmem_cache *c = list_entry (e, struct kmem_cache, elem);
+
+		if (c->allocs == 0)
+			continue;
+		printf ("Slab: %s: %zu-byte objects, %zu per slab, %llu slabs, "
+				"%llu allocs (%llu from magazine), %llu frees\n",
+				c->name, c->obj_size, c->objs_per_slab,
+				(unsigned long long) c->slabs,
+				(unsigned long long) c->allocs,
+				(unsigned long long) c->mag_hits,
+				(unsigned long long) c->frees);
+	}
+}
@@ -24,6 +24,14 @@
    #include <string.h>
    #include "threads/interrupt.h"
    #include "threads/thread.h"
+#ifdef LOCK_PROFILE
+   #include "devices/timer.h"
+
+   /* 이름이 붙은 세마포어와 락의 통계 목록.
+      이름을 붙인 객체만 목록에 들어가므로, 스택에 잠깐 만들어지는
+      세마포어가 목록에 남아 댕글링 포인터가 되는 일은 없습니다. */
+   static struct list sync_stat_list = LIST_INITIALIZER (sync_stat_list);
+#endif
    
    /* 세마포어 SEMA를 VALUE로 초기화합니다. 세마포어는 음이 아닌 정수이며
       이를 조작하는 두 개의 원자적 연산자를 가집니다:
@@ -37,6 +45,23 @@
    
        sema->value = value;
        list_init (&sema->waiters);
+#ifdef LOCK_PROFILE
+       memset (&sema->stat, 0, sizeof sema->stat);
+#endif
+   }
+
+   /* 경합 프로파일러의 보고서에 SEMA를 NAME으로 표시합니다.
+      NAME과 SEMA는 커널이 끝날 때까지 살아있어야 합니다.
+      LOCK_PROFILE 없이 빌드하면 아무 일도 하지 않습니다. */
+   void
+   sema_set_name (struct semaphore *sema UNUSED, const char *name UNUSED) {
+#ifdef LOCK_PROFILE
+       enum intr_level old_level = intr_disable ();
+       if (sema->stat.name == NULL)
+           list_push_back (&sync_stat_list, &sema->stat.elem);
+       sema->stat.name = name;
+       intr_set_level (old_level);
+#endif
    }
    
    /* 세마포어에서 Down 또는 "P" 연산입니다. SEMA의 값이 양수가 될 때까지 기다린 후
@@ -54,12 +79,28 @@
        ASSERT (!intr_context ());
    
        old_level = intr_disable ();
+#ifdef LOCK_PROFILE
+       int64_t wait_start = -1;
+       if (sema->value == 0) {
+           sema->stat.contended++;
+           wait_start = timer_ticks ();
+       }
+#endif
        while (sema->value == 0) {
            /* project 1.3 priority 를 위해 변경된 함수 */
            list_insert_ordered(&sema->waiters, &thread_current()->elem, cmp_prioirty, NULL);
            thread_block ();
        }
        sema->value--;
+#ifdef LOCK_PROFILE
+       sema->stat.acquires++;
+       if (wait_start >= 0) {
+           int64_t waited = timer_ticks () - wait_start;
+           sema->stat.wait_total += waited;
+           if (waited > sema->stat.wait_max)
+               sema->stat.wait_max = waited;
+       }
+#endif
        
        intr_set_level (old_level);
    }
@@ -80,6 +121,9 @@
        {
            sema->value--;
            success = true;
+#ifdef LOCK_PROFILE
+           sema->stat.acquires++;
+#endif
        }
        else
            success = false;
@@ -115,6 +159,8 @@
    }
    
    static void sema_test_helper (void *sema_);
+   static bool cmp_donor_priority (const struct heap_elem *,
+                                   const struct heap_elem *, void *);
    
    /* 한 쌍의 스레드 사이에서 제어를 "핑퐁"하도록 하는 세마포어 자체 테스트입니다.
       무엇이 일어나는지 보려면 printf() 호출을 삽입하세요. */
@@ -164,26 +210,103 @@
    
        lock->holder = NULL;
        sema_init (&lock->semaphore, 1);
+       heap_init (&lock->donors, cmp_donor_priority, NULL);
+       lock->priority = PRI_MIN - 1;
    }
    
    /* 
-       project 1.3 priority_donate 를 위해 추가된 함수 
-       이 함수는 내가 필요한 lock을 가지고 있으면서, 나보다 낮은 우선순위를 가진 쓰레드에게
-       자신이 가진 우선순위를 재귀적으로 기부합니다.
+       project 1.3 priority_donation 을 위한 힙 비교 함수들입니다.
+       lock->donors 는 대기 쓰레드의 priority, thread->held_locks 는
+       lock->priority 를 키로 하는 최대 힙입니다.
    */
-   void
-   priority_donate( struct thread *curr, struct thread* holder ) {
-   
-       /* 우선순위를 기부받았는데 기다리는 락이 있을 경우 */
-       if ( 
-           holder->waiting_lock != NULL && 
-           holder->waiting_lock->holder->priority < curr->priority 
-       ) {
-           holder->waiting_lock->holder->priority = curr->priority;
-           priority_donate(curr , holder->waiting_lock->holder );
+   static bool
+   cmp_donor_priority (
+       const struct heap_elem *a,
+       const struct heap_elem *b,
+       void *aux UNUSED
+   ) {
+       return heap_entry(a, struct thread, donor_elem)->priority
+           < heap_entry(b, struct thread, donor_elem)->priority;
+   }
+
+   bool
+   cmp_lock_priority (
+       const struct heap_elem *a,
+       const struct heap_elem *b,
+       void *aux UNUSED
+   ) {
+       return heap_entry(a, struct lock, held_elem)->priority
+           < heap_entry(b, struct lock, held_elem)->priority;
+   }
+
+   /* LOCK을 기다리는 쓰레드 중 가장 높은 priority 를 반환합니다. */
+   static int
+   lock_donor_priority (struct lock *lock) {
+       struct heap_elem *top = heap_top(&lock->donors);
+
+       return top != NULL ? heap_entry(top, struct thread, donor_elem)->priority
+                          : PRI_MIN - 1;
+   }
+
+   /* LOCK의 donors 가 바뀐 뒤 호출하여, 바뀐 최댓값을 holder 에게,
+      holder 가 기다리는 락의 holder 에게, ... 차례로 전달합니다.
+      힙의 키는 힙에 들어있는 동안 바뀌면 안 되므로, 키를 바꿀 때는
+      꺼냈다가 다시 넣습니다. 단계마다 O(log n)이고 priority 가 더 이상
+      바뀌지 않는 지점에서 멈추므로 전체 비용은 O(depth log n)입니다.
+      인터럽트가 꺼진 상태에서 호출되어야 합니다. */
+   static void
+   donation_propagate (struct lock *lock) {
+       ASSERT (intr_get_level () == INTR_OFF);
+
+       while (lock != NULL) {
+           int top = lock_donor_priority(lock);
+           struct thread *holder = lock->holder;
+
+           if (top == lock->priority)
+               return;
+           if (holder == NULL) {
+               lock->priority = top;
+               return;
+           }
+
+           heap_remove(&holder->held_locks, &lock->held_elem);
+           lock->priority = top;
+           heap_push(&holder->held_locks, &lock->held_elem);
+
+           int priority = thread_max_priority(holder);
+           if (priority == holder->priority)
+               return;
+
+           /* holder 도 락을 기다리고 있다면 그 락의 donors 에서 위치를 고칩니다. */
+           lock = holder->waiting_lock;
+           if (lock != NULL)
+               heap_remove(&lock->donors, &holder->donor_elem);
+           thread_change_priority(holder, priority);
+           if (lock != NULL)
+               heap_push(&lock->donors, &holder->donor_elem);
        }
    }
-   
+
+   /* 현재 쓰레드가 LOCK을 얻은 직후 호출합니다. LOCK을 held_locks 에
+      넣고, 남은 대기자들의 priority 를 기부받습니다. */
+   static void
+   lock_take (struct lock *lock) {
+       struct thread *curr = thread_current();
+
+       ASSERT (intr_get_level () == INTR_OFF);
+
+       lock->holder = curr;
+#ifdef LOCK_PROFILE
+       lock->semaphore.stat.acquired_at = timer_ticks ();
+#endif
+       if ( thread_mlfqs )
+           return;
+
+       lock->priority = lock_donor_priority(lock);
+       heap_push(&curr->held_locks, &lock->held_elem);
+       thread_change_priority(curr, thread_max_priority(curr));
+   }
+
    /* LOCK을 획득합니다. 필요한 경우 사용 가능해질 때까지 슬립합니다.
       락은 현재 스레드가 이미 보유하고 있어서는 안 됩니다.
    
@@ -201,27 +324,29 @@
        
        struct thread *curr = thread_current();
        /* 
-           누가 락을 들고 있으면 내가 어떤 락을 기다리는지 체크 
-           추후 thread_set_priority 가 일어났을 때, 변경해주기 위해서    
+           기다려야 하면 내가 어떤 락을 기다리는지 기록하고 donors 에 들어갑니다.
+           holder 가 막 락을 놓아 아직 NULL 이더라도, 다음 holder 가
+           lock_take 에서 donors 를 보고 기부를 받습니다.
        */
    
-       if ( lock->holder != NULL ) { 
+       /* mlfqs 에서는 priority donation 을 하지 않습니다. */
+       if ( lock->semaphore.value == 0 && !thread_mlfqs ) { 
            curr->waiting_lock = lock; 
-           
-           /* 내 priority 가 더 높은 경우만 기부를 한다. */
-           if ( lock->holder->priority < curr->priority ) {
-               lock->holder->priority = curr->priority;
-               list_push_front(&lock->holder->donation_list , &curr->donation_elem);
-               
-               /* TODO: holder의 donate_list에 넣어줄 함수 */
-               priority_donate(curr , lock->holder);
-           }
+           heap_push(&lock->donors, &curr->donor_elem);
+           donation_propagate(lock);
        }
            
        intr_set_level(old_level);
    
        sema_down (&lock->semaphore);
-       lock->holder = thread_current ();
+
+       old_level = intr_disable();
+       if ( curr->waiting_lock != NULL ) {
+           heap_remove(&lock->donors, &curr->donor_elem);
+           curr->waiting_lock = NULL;
+       }
+       lock_take(lock);
+       intr_set_level(old_level);
    }
    
    /* LOCK을 획득하려고 시도하고 성공하면 true를, 실패하면 false를 반환합니다.
@@ -235,9 +360,11 @@
        ASSERT (lock != NULL);
        ASSERT (!lock_held_by_current_thread (lock));
    
+       enum intr_level old_level = intr_disable();
        success = sema_try_down (&lock->semaphore);
        if (success)
-           lock->holder = thread_current ();
+           lock_take(lock);
+       intr_set_level(old_level);
        return success;
    }
    
@@ -253,23 +380,18 @@
    
        /* proect 1.3 priority_donation 을 위해 추가된 코드 */
        enum intr_level old_level = intr_disable();
-   
-       /* 1. lock을 해제하면서 donation_list에서 해당 lock 을 기다리는 쓰레드 제거 */
-       struct list_elem *e = list_begin( &lock->holder->donation_list );
-       while ( e != list_end( &lock->holder->donation_list) ) {
-           struct list_elem *next = list_next(e);
-           struct thread * curr = list_entry(e , struct thread, donation_elem); 
-           
-           if ( lock == curr->waiting_lock ) {
-               curr->waiting_lock = NULL;
-               list_remove(e);
-           }
-       
-           e = next;
+#ifdef LOCK_PROFILE
+       lock->semaphore.stat.hold_total +=
+           timer_ticks () - lock->semaphore.stat.acquired_at;
+#endif
+   
+       /* mlfqs 에서는 기부받은 priority 가 없으므로 되돌릴 것도 없습니다. */
+       if ( !thread_mlfqs ) {
+           /* 이 락으로 받은 기부를 빼고, 남은 락들 중 최댓값으로 되돌립니다.
+              대기자들은 donors 에 남아 다음 holder 에게 기부합니다. */
+           heap_remove(&lock->holder->held_locks, &lock->held_elem);
+           thread_change_priority(lock->holder, thread_max_priority(lock->holder));
        }
-   
-       /* 2. 아직 donation_list 에 무언가 남아있으면 가장 큰 값을 priority 로 설정*/
-       lock->holder->priority = thread_max_priority(lock->holder);
        lock->holder = NULL;
    
        intr_set_level(old_level);
@@ -277,6 +399,34 @@
        sema_up (&lock->semaphore);
    }
    
+   /* 경합 프로파일러의 보고서에 LOCK을 NAME으로 표시합니다.
+      sema_set_name()과 같은 제약이 있습니다. */
+   void
+   lock_set_name (struct lock *lock, const char *name) {
+       ASSERT (lock != NULL);
+
+       sema_set_name (&lock->semaphore, name);
+   }
+
+#ifdef LOCK_PROFILE
+   /* 이름이 붙은 세마포어와 락의 경합 통계를 출력합니다. */
+   void
+   synch_print_stats (void) {
+       struct list_elem *e;
+
+       for (e = list_begin (&sync_stat_list); e != list_end (&sync_stat_list);
+            e = list_next (e)) {
+           struct sync_stat *s = list_entry (e, struct sync_stat, elem);
+           printf ("Lock: %s: %llu acquires, %llu contended, "
+                   "%lld wait ticks (max %lld), %lld hold ticks\n",
+                   s->name, (unsigned long long) s->acquires,
+                   (unsigned long long) s->contended,
+                   (long long) s->wait_total, (long long) s->wait_max,
+                   (long long) s->hold_total);
+       }
+   }
+#endif
+
    /* 현재 스레드가 LOCK을 보유하고 있으면 true를, 그렇지 않으면 false를 반환합니다.
       (다른 스레드가 락을 보유하고 있는지 테스트하는 것은 경쟁 조건이 될 수 있습니다.) */
    bool
@@ -8,8 +8,10 @@
 #include "threads/interrupt.h"
 #include "threads/intr-stubs.h"
 #include "threads/palloc.h"
+#include "threads/slab.h"
 #include "threads/synch.h"
 #include "threads/vaddr.h"
+#include "devices/timer.h"
 #include "intrinsic.h"
 #ifdef USERPROG
 #include "userprog/process.h"
@@ -26,11 +28,31 @@
 #define THREAD_BASIC 0xd42df210
 
 /* THREAD_READY 상태의 프로세스 목록, 즉 실행 준비가 되었지만
-   실제로 실행되지 않는 프로세스들입니다. */
-static struct list ready_list;
+   실제로 실행되지 않는 프로세스들입니다. 인터럽트를 끄고 접근합니다.
+   우선순위마다 하나씩 FIFO 큐를 두고, ready_queues[p]에는
+   priority가 p인 쓰레드만 들어갑니다. */
+static struct list ready_queues[PRI_MAX + 1];
+
+/* ready_queues[p]가 비어있지 않으면 p번 비트가 켜집니다.
+   bsr 한 번으로 가장 높은 우선순위의 큐를 O(1)에 찾을 수 있습니다. */
+static uint64_t ready_bitmap;
+#if PRI_MAX - PRI_MIN >= 64
+#error ready_bitmap requires at most 64 priority levels
+#endif
+
+/* ready 큐에 들어있는 쓰레드 수. mlfqs의 load_avg 계산에 사용됩니다. */
+static int ready_threads;
+
+/* 생성된 뒤 아직 종료되지 않은 모든 쓰레드의 목록입니다.
+   mlfqs 가 1초마다 recent_cpu 를 감쇠시킬 때 사용합니다. */
+static struct list all_list;
+
+/* 마지막 priority 계산 이후 recent_cpu 가 바뀐 쓰레드들입니다.
+   4틱마다 모든 쓰레드를 다시 계산하는 대신 이 목록만 계산합니다. */
+static struct list mlfqs_dirty_list;
 
-/* 쉬는 상태의 쓰레드 목록, 즉 BLOCK 된 쓰레드들 입니다. */
-static struct list sleep_list;
+/* 시스템 load average (고정소수점). */
+static fixed_t load_avg;
 
 /* 접근할 수 없는 공유자원을 기다리는 쓰레드들 입니다. */
 static struct list wait_list;
@@ -47,6 +69,9 @@ static struct lock tid_lock;
 /* 스레드 소멸 요청 */
 static struct list destruction_req;
 
+/* 파일 디스크립터 테이블 항목의 캐시. */
+struct kmem_cache fdt_entry_cache;
+
 /* 통계. */
 static long long idle_ticks;    /* 유휴 상태에서 소비된 타이머 틱 수. */
 static long long kernel_ticks;  /* 커널 스레드에서 소비된 타이머 틱 수. */
@@ -56,9 +81,6 @@ static long long user_ticks;    /* 사용자 프로그램에서 소비된 타이
 #define TIME_SLICE 4            /* 각 스레드에 할당할 타이머 틱 수. */
 static unsigned thread_ticks;   /* 마지막 양보 이후 타이머 틱 수. */
 
-/* alarm 구현을 위한 minimum tick */
-static int64_t minimum_tick = INT64_MAX; /* Sleep_list 에 있는 쓰레드 tick 중 가장 작은 값 */
-
 /* false(기본값)이면 라운드 로빈 스케줄러를 사용합니다.
    true이면 다단계 피드백 큐 스케줄러를 사용합니다.
    커널 명령줄 옵션 "-o mlfqs"로 제어됩니다. */
@@ -72,6 +94,14 @@ static void init_thread (struct thread *, const char *name, int priority);
 static void do_schedule(int status);
 static void schedule (void);
 static tid_t allocate_tid (void);
+static void ready_queue_push (struct thread *);
+static void ready_queue_remove (struct thread *);
+static struct thread *ready_queue_pop (void);
+static int ready_queue_max_priority (void);
+static int mlfqs_calc_priority (const struct thread *);
+static void mlfqs_refresh_priority (struct thread *);
+static void mlfqs_tick (struct thread *);
+static void mlfqs_second (void);
 
 /* T가 유효한 스레드를 가리키는 것으로 보이면 true를 반환합니다. */
 #define is_thread(t) ((t) != NULL && (t)->magic == THREAD_MAGIC)
@@ -115,9 +145,16 @@ thread_init (void) {
 
 	/* 전역 스레드 컨텍스트를 초기화합니다. */
 	lock_init (&tid_lock);
-
-	list_init (&ready_list);
-    list_init( &sleep_list);
+	kmem_cache_init (&fdt_entry_cache, "fdt_entry",
+			sizeof (struct fdt_entry), NULL);
+
+	for (int i = PRI_MIN; i <= PRI_MAX; i++)
+		list_init (&ready_queues[i]);
+	ready_bitmap = 0;
+	ready_threads = 0;
+	list_init (&all_list);
+	list_init (&mlfqs_dirty_list);
+	load_avg = fp_from_int (0);
 	list_init (&destruction_req);
 
 	/* 실행 중인 스레드를 위한 스레드 구조체를 설정합니다. */
@@ -159,6 +196,10 @@ void
 	else
 		kernel_ticks++;
 
+	/* project 1.4 mlfqs 의 recent_cpu, load_avg, priority 갱신 */
+	if (thread_mlfqs)
+		mlfqs_tick (t);
+
     /* 선점을 강제합니다. */
 	if (++thread_ticks >= TIME_SLICE)
 		intr_yield_on_return ();
@@ -169,6 +210,9 @@ void
 thread_print_stats (void) {
 	printf ("Thread: %lld idle ticks, %lld kernel ticks, %lld user ticks\n",
 			idle_ticks, kernel_ticks, user_ticks);
+	if (timer_tickless)
+		printf ("Thread: %lld idle ticks skipped by tickless idle\n",
+				(long long) timer_skipped_ticks ());
 }
 
 /* 주어진 초기 PRIORITY로 NAME이라는 새로운 커널 스레드를 생성하고,
@@ -208,7 +252,7 @@ thread_create (const char *name, int priority,
 	t->fdt = fdt;
 	//t->next_fd = 3;
 	for (int i = 0; i < 3; i++) {
-		t->fdt[i] = calloc(1, sizeof(struct fdt_entry)); // fd : 0~2까지만 공간 할당, 나머지는 알아서 NULL (calloc으로 받았으니까)
+		t->fdt[i] = kmem_cache_zalloc(&fdt_entry_cache); // fd : 0~2까지만 공간 할당, 나머지는 알아서 NULL (calloc으로 받았으니까)
 	}
 	
 	t->exec_file = NULL;
@@ -289,7 +333,7 @@ thread_unblock (struct thread *t) {
 	old_level = intr_disable ();
 	ASSERT (t->status == THREAD_BLOCKED);
 
-	list_insert_ordered(&ready_list, &t->elem, cmp_prioirty, NULL);
+	ready_queue_push (t);
 	t->status = THREAD_READY;
 
     intr_set_level (old_level);
@@ -348,15 +392,21 @@ thread_exit (void) {
 
 	list_remove(&t->child_elem);	
 
+	/* mlfqs 가 더 이상 이 쓰레드를 계산하지 않도록 목록에서 뺍니다. */
+	list_remove(&t->all_elem);
+	if (t->mlfqs_dirty) {
+		list_remove(&t->mlfqs_elem);
+		t->mlfqs_dirty = false;
+	}
+
 	free(t->waiting_lock);
 
 	for (int i = 0; i < 128; i++) {
 		if (t->fdt[i] != NULL)
-			free(t->fdt[i]);
+			kmem_cache_free(&fdt_entry_cache, t->fdt[i]);
 	}
 
 	free(t->fdt);
-	free(t->exec_file);
 
 	do_schedule (THREAD_DYING);
 	NOT_REACHED ();
@@ -373,9 +423,9 @@ thread_yield (void) {
 
 	old_level = intr_disable ();
 	
-    // 현재 스레드가 유휴 스레드가 아니면 ready_list 에 넣습니다.
+    // 현재 스레드가 유휴 스레드가 아니면 ready 큐에 넣습니다.
     if (curr != idle_thread)
-        list_insert_ordered(&ready_list, &curr->elem, cmp_prioirty, NULL);
+        ready_queue_push (curr);
 	
     do_schedule (THREAD_READY);
 	intr_set_level (old_level);
@@ -384,14 +434,14 @@ thread_yield (void) {
 /* 
 사용하는 이유
 - idle_thread가 잘못 yield하지 않도록 보호
-- ready_list가 비어 있는 상황에서 불필요한 switch 방지
+- ready 큐가 비어 있는 상황에서 불필요한 switch 방지
 - assert 실패 방지
 */
 void thread_try_yield() {
 
 	enum intr_level old_level = intr_disable();
 
-	if (!list_empty(&ready_list) && thread_current ()->priority < list_entry(list_front(&ready_list), struct thread, elem)->priority) {
+	if (thread_current ()->priority < ready_queue_max_priority ()) {
 		if(intr_context()) {
 			intr_yield_on_return();
 		}
@@ -403,139 +453,46 @@ void thread_try_yield() {
 	intr_set_level (old_level);
 }
 
-/* 
-    project 1.1 alarm 을 위한 함수
-    리스트를 ticks 기준으로 내림차순 정렬 insert 할 때 사용합니다.
-    a는 방금 입력된 쓰레드, b는 기존에 리스트에 있던 쓰레드 입니다.
-*/
-bool
-cmp_ticks(
-    const struct list_elem *a,
-    const struct list_elem *b,
-    void * aux
-) {
-    int a_ticks = list_entry(a, struct thread, elem)->ticks;
-    int b_ticks = list_entry(b, struct thread, elem)->ticks;
-
-    return a_ticks < b_ticks;
-}
-
-/* 
-    project 1.1 alarm 을 위해 추가된 함수
-    ㅋㅋ 이거 찾아보셈
-    현재 쓰레드를 ticks 초 동안 쉬게 만듭니다. 
+/*
+    project 1.3 priority_donation 에서 필요한 쓰레드에서 가장 높은 우선순위를 반환하는 함수
+    T가 가진 락 중 가장 높은 대기자의 priority 와 T의 원래 priority 중 큰 값입니다.
+    held_locks 는 lock->priority 최대 힙이므로 맨 위만 보면 됩니다.
 */
-void 
-thread_sleep(int64_t ticks){
-    struct thread *t = thread_current();
-
-    /* 쓰레드 리스트를 조작할 때는 인터럽트를 비활성화 시키기 */
-    enum intr_level old_level = intr_disable();
+int
+thread_max_priority (struct thread *t) {
+    struct heap_elem *top = heap_top( &t->held_locks );
 
-    /* 1. 현재 스레드가 idle 쓰레드가 아니라면 */
-    if ( t != idle_thread) {
-        /* 2. 깨울 시점의 tick 값을 저장 */
-        t->ticks = ticks;
-    
-        /* 3. sleep list에 ticks 값 기준으로 정렬 */
-        list_insert_ordered(&sleep_list, &t->elem, cmp_ticks, NULL);
-        
-        /* 4. minimum_tick 갱신 */
-        set_minimum_tick(); 
-        
-        /* thread 를 sleep_list 로 */    
-        thread_block();
+    if ( top == NULL ) {
+        return t->origin_priority;
+    } else {
+        return max ( 
+            t->origin_priority,
+            heap_entry(top, struct lock, held_elem)->priority 
+        );
     }
-    
-    intr_set_level(old_level);
 }
 
-/* 
-    project 1.1 alarm을 위한 함수
-    sleep_list 에서 조건에 맞는 thread를 ready_list로 옮겨줍니다. 
+/*
+    쓰레드 T의 실제 우선순위를 PRIORITY로 바꿉니다.
+    T가 ready 큐에 있으면 새 우선순위의 큐로 옮겨줍니다.
+    priority 를 직접 대입하면 T가 엉뚱한 큐에 남게 되므로 반드시 이 함수를 사용합니다.
 */
 void
-thread_wakeup() {
-    struct list_elem *e;
+thread_change_priority (struct thread *t, int priority) {
+    ASSERT (is_thread (t));
+    ASSERT (PRI_MIN <= priority && priority <= PRI_MAX);
 
     enum intr_level old_level = intr_disable();
 
-    e = list_begin(&sleep_list);
-
-    while ( e != list_end(&sleep_list) ) {
-        struct list_elem *next = list_next(e);
-        struct thread *current = list_entry(e, struct thread, elem);
-
-        if ( current->ticks <= timer_ticks()) {
-            list_remove(e);
-            thread_unblock(current);
-
-            /* 
-                thread_wakeup 은 무조건 timer interrupt 안에서 호출됩니다.
-                따라서 thread_yield 가 아닌 intr_yield_on_return 을 사용해줘야 안전합니다.
-            */
-            intr_yield_on_return ();
-        } else {
-            break;
-        }
-        
-        e = next;
-    }
-
-    /* sleep_list가 변경되었을 가능성이 있으므로 min_tick 을 갱신해줍니다. */
-    set_minimum_tick();
-    intr_set_level(old_level);
-}
-
-/* 
-    project 1.1 alarm 을 위한 함수
-    minimum_tick 을 sleep_list의 가장 작은 tick과 비교해서 갱신합니다. 
-    set_minimum_tick 은 intr 을 멈춘 상황에서만 호출되기 때문에,
-    사용하지 않아도 안전합니다.
-    
-    다만 더 보안에 신경쓰고 싶다면 intr 를 호출해도 상관 없습니다.
-*/
-void 
-set_minimum_tick(void){
-    ASSERT(intr_get_level() == INTR_OFF);
-
-    minimum_tick = INT64_MAX;
-    
-    if (list_empty(&sleep_list)) {
-        return;
+    if ( t->status == THREAD_READY && t->priority != priority ) {
+        ready_queue_remove(t);
+        t->priority = priority;
+        ready_queue_push(t);
+    } else {
+        t->priority = priority;
     }
-    
-    struct thread *t = list_entry(list_begin(&sleep_list), struct thread, elem);
-    minimum_tick = min ( minimum_tick , t->ticks );
-}
 
-/* 
-    project 1.1 alarm 을 위한 함수
-    minimum_tick 값을 반환합니다. 
-*/
-int64_t
-get_minimum_tick(void){
-    enum intr_level old_level = intr_disable();
-    int64_t m = minimum_tick;
     intr_set_level(old_level);
-    barrier();
-    return m;
-};
-
-
-/*
-    project 1.3 priority_donation 에서 필요한 쓰레드에서 가장 높은 우선순위를 반환하는 함수
-*/
-int
-thread_max_priority (struct thread *t) {
-    if ( list_empty( &t->donation_list ) ) {
-        return t->origin_priority;
-    } else {
-        return max ( 
-            t->origin_priority,
-            list_entry(list_begin(&t->donation_list), struct thread, donation_elem)->priority 
-        );
-    }
 }
 
 /* 현재 스레드의 우선순위를 NEW_PRIORITY로 설정합니다. */
@@ -543,14 +500,16 @@ thread_max_priority (struct thread *t) {
 /* 만약 현재 스레드의 우선순위가 더 이상 높지 않으면 우선순위를 양보합니다. */
 void
 thread_set_priority (int new_priority) {
-    
+    /* mlfqs 에서는 스케줄러가 priority 를 직접 계산하므로 무시합니다. */
+    if (thread_mlfqs)
+        return;
+
     enum intr_level old_level = intr_disable();
     struct thread *t = thread_current(); 
 	t->origin_priority = new_priority;
     t->priority = thread_max_priority(t);
-    /* TODO : priority 가 변경된 후 , donation_list 를 살펴보고 가장 높은 걸로 갱신? */
 
-    if ( t->priority < list_entry(list_begin(&ready_list), struct thread, elem)->priority )  {
+    if ( t->priority < ready_queue_max_priority () )  {
         intr_set_level(old_level);
         thread_yield();
     } else {
@@ -566,30 +525,151 @@ thread_get_priority (void) {
 }
 
 /* 현재 스레드의 nice 값을 NICE로 설정합니다. */
+/* nice 가 바뀌면 priority 를 다시 계산하고, 더 이상 가장 높은 우선순위가
+   아니면 양보합니다. */
 void
-thread_set_nice (int nice UNUSED) {
-	/* TODO: 여기에 구현을 추가하세요 */
+thread_set_nice (int nice) {
+	ASSERT (NICE_MIN <= nice && nice <= NICE_MAX);
+
+	enum intr_level old_level = intr_disable ();
+	struct thread *t = thread_current ();
+
+	t->nice = nice;
+	mlfqs_refresh_priority (t);
+	intr_set_level (old_level);
+
+	thread_try_yield ();
 }
 
 /* 현재 스레드의 nice 값을 반환합니다. */
 int
 thread_get_nice (void) {
-	/* TODO: 여기에 구현을 추가하세요 */
-	return 0;
+	return thread_current ()->nice;
 }
 
 /* 시스템 로드 평균의 100배를 반환합니다. */
 int
 thread_get_load_avg (void) {
-	/* TODO: 여기에 구현을 추가하세요 */
-	return 0;
+	enum intr_level old_level = intr_disable ();
+	int load = fp_round (fp_mul_int (load_avg, 100));
+	intr_set_level (old_level);
+
+	return load;
 }
 
 /* 현재 스레드의 recent_cpu 값의 100배를 반환합니다. */
 int
 thread_get_recent_cpu (void) {
-	/* TODO: 여기에 구현을 추가하세요 */
-	return 0;
+	enum intr_level old_level = intr_disable ();
+	int recent = fp_round (fp_mul_int (thread_current ()->recent_cpu, 100));
+	intr_set_level (old_level);
+
+	return recent;
+}
+
+/* 
+    project 1.4 mlfqs 를 위한 함수
+    priority = PRI_MAX - (recent_cpu / 4) - (nice * 2) 를 PRI_MIN~PRI_MAX 로 잘라 반환합니다.
+*/
+static int
+mlfqs_calc_priority (const struct thread *t) {
+	int priority = PRI_MAX - fp_to_int (fp_div_int (t->recent_cpu, 4)) - t->nice * 2;
+
+	if (priority < PRI_MIN)
+		priority = PRI_MIN;
+	if (priority > PRI_MAX)
+		priority = PRI_MAX;
+	return priority;
+}
+
+/* 
+    project 1.4 mlfqs 를 위한 함수
+    T의 priority 를 다시 계산하고, 재계산 대기 목록에 있었다면 뺍니다.
+*/
+static void
+mlfqs_refresh_priority (struct thread *t) {
+	ASSERT (intr_get_level () == INTR_OFF);
+
+	if (t == idle_thread)
+		return;
+
+	if (t->mlfqs_dirty) {
+		list_remove (&t->mlfqs_elem);
+		t->mlfqs_dirty = false;
+	}
+	thread_change_priority (t, mlfqs_calc_priority (t));
+}
+
+/* 
+    project 1.4 mlfqs 를 위한 함수
+    매 틱 타이머 인터럽트에서 호출됩니다.
+
+    1초 사이에 recent_cpu 가 바뀌는 쓰레드는 그동안 실행된 쓰레드뿐이므로,
+    4틱마다 모든 쓰레드를 다시 계산하지 않고 mlfqs_dirty_list 에 모인
+    쓰레드만 다시 계산합니다. 1초마다 하는 감쇠는 all_list 를 한 번만 돕니다.
+*/
+static void
+mlfqs_tick (struct thread *t) {
+	int64_t now = timer_ticks ();
+
+	/* 1. 실행 중인 쓰레드의 recent_cpu 를 1 증가 */
+	if (t != idle_thread) {
+		t->recent_cpu = fp_add_int (t->recent_cpu, 1);
+		if (!t->mlfqs_dirty) {
+			t->mlfqs_dirty = true;
+			list_push_back (&mlfqs_dirty_list, &t->mlfqs_elem);
+		}
+	}
+
+	if (now % TIMER_FREQ == 0) {
+		/* 2. 1초마다 load_avg 와 모든 쓰레드의 recent_cpu, priority 갱신 */
+		mlfqs_second ();
+	} else if (now % 4 == 0) {
+		/* 3. 4틱마다 recent_cpu 가 바뀐 쓰레드의 priority 만 갱신 */
+		while (!list_empty (&mlfqs_dirty_list)) {
+			struct thread *d = list_entry (list_front (&mlfqs_dirty_list),
+					struct thread, mlfqs_elem);
+			mlfqs_refresh_priority (d);
+		}
+	}
+
+	/* 더 높은 우선순위의 쓰레드가 생겼으면 양보합니다. */
+	if (t->priority < ready_queue_max_priority ())
+		intr_yield_on_return ();
+}
+
+/* 
+    project 1.4 mlfqs 를 위한 함수
+    load_avg = (59/60) * load_avg + (1/60) * ready_threads
+    recent_cpu = (2 * load_avg) / (2 * load_avg + 1) * recent_cpu + nice
+    를 계산하고, 모든 쓰레드의 priority 를 한 번에 갱신합니다.
+*/
+static void
+mlfqs_second (void) {
+	int ready = ready_threads;
+	if (thread_current () != idle_thread)
+		ready++;
+
+	load_avg = fp_add (fp_mul (fp_div_int (fp_from_int (59), 60), load_avg),
+			fp_mul_int (fp_div_int (fp_from_int (1), 60), ready));
+
+	/* 감쇠 계수는 모든 쓰레드에 같으므로 한 번만 계산합니다. */
+	fixed_t twice_load = fp_mul_int (load_avg, 2);
+	fixed_t decay = fp_div (twice_load, fp_add_int (twice_load, 1));
+
+	struct list_elem *e;
+	for (e = list_begin (&all_list); e != list_end (&all_list); e = list_next (e)) {
+		struct thread *t = list_entry (e, struct thread, all_elem);
+		if (t == idle_thread)
+			continue;
+
+		t->recent_cpu = fp_add_int (fp_mul (decay, t->recent_cpu), t->nice);
+		t->mlfqs_dirty = false;
+		thread_change_priority (t, mlfqs_calc_priority (t));
+	}
+
+	/* 모든 쓰레드를 다시 계산했으므로 대기 목록을 비웁니다. */
+	list_init (&mlfqs_dirty_list);
 }
 
 /* 유휴 스레드. 다른 스레드가 실행 준비가 되지 않았을 때 실행됩니다.
@@ -612,6 +692,16 @@ idle (void *idle_started_ UNUSED) {
 		intr_disable ();
 		thread_block ();
 
+		/* 실행할 쓰레드가 없는 동안 PAL_ZERO 요청에 쓸 페이지를 미리
+		   0으로 채워 둡니다. 그 사이 인터럽트가 쓰레드를 깨우면 선점됩니다. */
+		intr_enable ();
+		palloc_refill_zeroed ();
+		intr_disable ();
+
+		/* 실행할 쓰레드가 없으므로, tickless 모드라면 다음 타이머 만료
+		   시각까지 주기적인 타이머 인터럽트를 멈춥니다. */
+		timer_idle_enter ();
+
 		/* 인터럽트를 다시 활성화하고 다음 인터럽트를 기다립니다.
 
 		   'sti' 명령은 다음 명령이 완료될 때까지 인터럽트를 비활성화하므로,
@@ -665,7 +755,25 @@ init_thread (struct thread *t, const char *name, int priority) {
 
 	list_init(&t->child_list);
 
-    list_init(&t->donation_list);
+    heap_init(&t->held_locks, cmp_lock_priority, NULL);
+
+	/* project 1.4 mlfqs: nice 와 recent_cpu 는 부모에게서 물려받습니다. */
+	if (t == initial_thread) {
+		t->nice = NICE_DEFAULT;
+		t->recent_cpu = fp_from_int (0);
+	} else {
+		t->nice = thread_current ()->nice;
+		t->recent_cpu = thread_current ()->recent_cpu;
+	}
+	t->mlfqs_dirty = false;
+	if (thread_mlfqs) {
+		t->priority = mlfqs_calc_priority (t);
+		t->origin_priority = t->priority;
+	}
+
+	enum intr_level old_level = intr_disable ();
+	list_push_back (&all_list, &t->all_elem);
+	intr_set_level (old_level);
 
 }
 
@@ -675,10 +783,58 @@ init_thread (struct thread *t, const char *name, int priority) {
    반환합니다. */
 static struct thread *
 next_thread_to_run (void) {
-	if (list_empty (&ready_list))
+	if (ready_bitmap == 0)
 		return idle_thread;
 	else
-		return list_entry (list_pop_front (&ready_list), struct thread, elem);
+		return ready_queue_pop ();
+}
+
+/* T를 자신의 priority에 해당하는 ready 큐의 맨 뒤에 넣습니다.
+   인터럽트가 꺼진 상태에서 호출되어야 합니다. */
+static void
+ready_queue_push (struct thread *t) {
+	ASSERT (intr_get_level () == INTR_OFF);
+	ASSERT (PRI_MIN <= t->priority && t->priority <= PRI_MAX);
+
+	list_push_back (&ready_queues[t->priority], &t->elem);
+	ready_bitmap |= 1ULL << t->priority;
+	ready_threads++;
+}
+
+/* ready 큐에 들어있는 T를 꺼냅니다. T->priority는 T가 들어갈 때의
+   값과 같아야 합니다. */
+static void
+ready_queue_remove (struct thread *t) {
+	ASSERT (intr_get_level () == INTR_OFF);
+
+	list_remove (&t->elem);
+	if (list_empty (&ready_queues[t->priority]))
+		ready_bitmap &= ~(1ULL << t->priority);
+	ready_threads--;
+}
+
+/* 가장 높은 우선순위 큐의 맨 앞 쓰레드를 꺼내 반환합니다.
+   ready 큐가 비어있으면 안 됩니다. */
+static struct thread *
+ready_queue_pop (void) {
+	ASSERT (ready_bitmap != 0);
+
+	int pri = bsr (ready_bitmap);
+	struct thread *t = list_entry (list_pop_front (&ready_queues[pri]),
+			struct thread, elem);
+	if (list_empty (&ready_queues[pri]))
+		ready_bitmap &= ~(1ULL << pri);
+	ready_threads--;
+	return t;
+}
+
+/* ready 큐에서 가장 높은 우선순위를 반환합니다.
+   ready 큐가 비어있으면 PRI_MIN - 1을 반환합니다. */
+static int
+ready_queue_max_priority (void) {
+	if (ready_bitmap == 0)
+		return PRI_MIN - 1;
+	return bsr (ready_bitmap);
 }
 
 /* iretq를 사용하여 스레드를 시작합니다 */
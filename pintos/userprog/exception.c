@@ -1,14 +1,31 @@
 #include "userprog/exception.h"
 #include <inttypes.h>
 #include <stdio.h>
+#include <string.h>
 #include "userprog/gdt.h"
 #include "threads/interrupt.h"
 #include "threads/thread.h"
+#include "threads/vaddr.h"
 #include "intrinsic.h"
+#ifdef VM
+#include <pfstat.h>
+#endif
 
 /* 처리된 페이지 폴트 수 */
 static long long page_fault_cnt;
 
+#ifdef VM
+/* 종류별 페이지 폴트 지연 시간. 인터럽트를 끄고 갱신합니다. */
+static struct fault_hist fault_hists[FAULT_CLASS_CNT];
+
+static const char *fault_class_names[FAULT_CLASS_CNT] = {
+	"uninit->anon", "uninit->file", "swap-in", "file re-read",
+	"stack growth", "COW", "invalid",
+};
+
+static void fault_record (enum fault_class, uint64_t start);
+#endif
+
 static void kill (struct intr_frame *);
 static void page_fault (struct intr_frame *);
 
@@ -59,8 +76,62 @@ exception_init (void) {
 void
 exception_print_stats (void) {
 	printf ("Exception: %lld page faults\n", page_fault_cnt);
+#ifdef VM
+	for (int c = 0; c < FAULT_CLASS_CNT; c++) {
+		const struct fault_hist *h = &fault_hists[c];
+
+		if (h->count == 0)
+			continue;
+		printf ("  %-12s %8llu faults, avg %llu, max %llu cycles;",
+				fault_class_names[c], (unsigned long long) h->count,
+				(unsigned long long) (h->cycles / h->count),
+				(unsigned long long) h->max);
+		for (int b = 0; b < FAULT_HIST_BUCKETS; b++)
+			if (h->buckets[b] > 0)
+				printf (" 2^%d:%llu", b, (unsigned long long) h->buckets[b]);
+		printf ("\n");
+	}
+#endif
 }
 
+#ifdef VM
+/* START에 시작한 CLS 종류의 폴트를 현재 스레드와 시스템 전체 통계에
+ * 더합니다. */
+static void
+fault_record (enum fault_class cls, uint64_t start) {
+	struct thread *t = thread_current ();
+	uint64_t cycles = rdtsc () - start;
+	struct fault_hist *h = &fault_hists[cls];
+	int b = cycles > 0 ? 63 - __builtin_clzll (cycles) : 0;
+	enum intr_level old_level;
+
+	if (b >= FAULT_HIST_BUCKETS)
+		b = FAULT_HIST_BUCKETS - 1;
+
+	old_level = intr_disable ();
+	h->count++;
+	h->cycles += cycles;
+	if (cycles > h->max)
+		h->max = cycles;
+	h->buckets[b]++;
+	t->fault_cnt[cls]++;
+	t->fault_cycles[cls] += cycles;
+	intr_set_level (old_level);
+}
+
+/* 시스템 전체와 현재 프로세스의 페이지 폴트 통계를 BUF에 복사합니다. */
+void
+exception_pfstat (struct pfstat *buf) {
+	struct thread *t = thread_current ();
+	enum intr_level old_level = intr_disable ();
+
+	memcpy (buf->sys, fault_hists, sizeof buf->sys);
+	memcpy (buf->proc_count, t->fault_cnt, sizeof buf->proc_count);
+	memcpy (buf->proc_cycles, t->fault_cycles, sizeof buf->proc_cycles);
+	intr_set_level (old_level);
+}
+#endif
+
 /* (아마도) 사용자 프로세스에 의해 발생된 예외의 핸들러입니다. */
 static void
 kill (struct intr_frame *f) {
@@ -112,6 +183,9 @@ page_fault (struct intr_frame *f) {
 	bool write;        /* True: 접근이 쓰기였음, false: 접근이 읽기였음. */
 	bool user;         /* True: 사용자에 의한 접근, false: 커널에 의한 접근. */
 	void *fault_addr;  /* 폴트 주소. */
+#ifdef VM
+	uint64_t start = rdtsc ();
+#endif
 
 	/* 폴트 주소를 얻습니다. 이는 폴트를 발생시킨 접근의 대상이 된 가상 주소입니다.
 	   이것은 코드나 데이터를 가리킬 수 있습니다. 이것이 반드시 폴트를 발생시킨
@@ -132,14 +206,19 @@ page_fault (struct intr_frame *f) {
 
 #ifdef VM
 /* 프로젝트 3 이후를 위한 것입니다. */
-	if (vm_try_handle_fault (f, fault_addr, user, write, not_present))
+	thread_current ()->fault_class = FAULT_INVALID;
+	if (vm_try_handle_fault (f, fault_addr, user, write, not_present)) {
+		fault_record (thread_current ()->fault_class, start);
 		return;
+	}
+	fault_record (FAULT_INVALID, start);
 #endif
 
 	/* 페이지 폴트를 카운트합니다. */
 	page_fault_cnt++;
 
-	if (user) exit(-1);
+	/* 시스템 콜이 잘못된 사용자 주소를 건드린 경우도 프로세스를 종료합니다. */
+	if (user || is_user_vaddr (fault_addr)) exit(-1);
 	else {
 		/* 폴트가 실제 폴트라면, 정보를 보여주고 종료합니다. */
 		printf ("Page fault at %p: %s error %s page in %s context.\n",
@@ -13,13 +13,16 @@
 #include "threads/flags.h"
 #include "threads/init.h"
 #include "threads/interrupt.h"
+#include "threads/malloc.h"
 #include "threads/palloc.h"
+#include "threads/slab.h"
 #include "threads/thread.h"
 #include "threads/mmu.h"
 #include "threads/vaddr.h"
 #include "intrinsic.h"
 #ifdef VM
 #include "vm/vm.h"
+#include "vm/exectrace.h"
 #endif
 
 
@@ -196,7 +199,7 @@ __do_fork (void *aux) {
 	// }
 	for (int fd = 0; fd < 128; fd++) {
 		if (parent->fdt[fd] != NULL && parent->fdt[fd]->type == 1) { // FILE 의미가 겹쳐서 여기서만 1로 사용
-			current->fdt[fd] = calloc(1, sizeof(struct fdt_entry));
+			current->fdt[fd] = kmem_cache_zalloc(&fdt_entry_cache);
 			current->fdt[fd]->type = 1;
 			current->fdt[fd]->entry = file_duplicate(parent->fdt[fd]->entry);
 		}
@@ -351,6 +354,7 @@ process_cleanup (void) {
 	struct thread *curr = thread_current ();
 
 #ifdef VM
+	exec_trace_finish ();
 	supplemental_page_table_kill (&curr->spt);
 #endif
 
@@ -552,6 +556,11 @@ load (const char *file_name, struct intr_frame *if_) {
 	if_->rsp = USER_STACK;
 
 	init_stack_frame(if_, argv, argc);
+
+#ifdef VM
+	/* 이전 실행에서 기록한 페이지를 사용자 모드로 넘어가기 전에 올립니다. */
+	exec_trace_start (file);
+#endif
 	
 	success = true;
 
@@ -754,9 +763,20 @@ install_page (void *upage, void *kpage, bool writable) {
 
 static bool
 lazy_load_segment (struct page *page, void *aux) {
-	/* TODO: 파일에서 세그먼트를 로드합니다 */
-	/* TODO: 이것은 주소 VA에서 첫 번째 페이지 폴트가 발생할 때 호출됩니다. */
-	/* TODO: 이 함수를 호출할 때 VA를 사용할 수 있습니다. */
+	/* 파일에서 세그먼트의 한 페이지를 읽고 나머지를 0으로 채웁니다.
+	 * 이 페이지의 첫 페이지 폴트에서 호출되며, aux는 load_segment가 만든
+	 * 세그먼트 영역입니다. 읽은 뒤에는 익명 페이지가 됩니다. */
+	struct vm_area *vma = aux;
+	void *kva = page->frame->kva;
+	size_t read_bytes;
+	off_t ofs;
+
+	vm_area_page (vma, page->va, &ofs, &read_bytes);
+	if (file_read_at (vma->file, kva, read_bytes, ofs) != (off_t) read_bytes)
+		return false;
+	memset ((uint8_t *) kva + read_bytes, 0, PGSIZE - read_bytes);
+	exec_trace_record (page);
+	return true;
 }
 
 /* FILE의 오프셋 OFS에서 시작하여 주소 UPAGE로 세그먼트를 로드합니다.
@@ -777,25 +797,12 @@ load_segment (struct file *file, off_t ofs, uint8_t *upage,
 	ASSERT (pg_ofs (upage) == 0);
 	ASSERT (ofs % PGSIZE == 0);
 
-	while (read_bytes > 0 || zero_bytes > 0) {
-		/* 이 페이지를 채우는 방법을 계산합니다.
-		 * FILE에서 PAGE_READ_BYTES 바이트를 읽고
-		 * 마지막 PAGE_ZERO_BYTES 바이트를 0으로 채웁니다. */
-		size_t page_read_bytes = read_bytes < PGSIZE ? read_bytes : PGSIZE;
-		size_t page_zero_bytes = PGSIZE - page_read_bytes;
-
-		/* TODO: lazy_load_segment에 정보를 전달하기 위해 aux를 설정합니다. */
-		void *aux = NULL;
-		if (!vm_alloc_page_with_initializer (VM_ANON, upage,
-					writable, lazy_load_segment, aux))
-			return false;
-
-		/* 진행합니다. */
-		read_bytes -= page_read_bytes;
-		zero_bytes -= page_zero_bytes;
-		upage += PGSIZE;
-	}
-	return true;
+	/* 세그먼트 전체를 영역 하나로 만들고 페이지는 폴트가 날 때 만듭니다.
+	 * 파일 내용이 끝난 뒤의 페이지(BSS)는 빈 익명 페이지가 되어, 읽기만
+	 * 하면 공유 제로 페이지로 처리됩니다. 파일은 영역이 따로 열어
+	 * 프로세스가 exec_file을 닫아도 안전합니다. */
+	return vm_alloc_region (upage, read_bytes + zero_bytes, VM_ANON, writable,
+			lazy_load_segment, file, ofs, read_bytes);
 }
 
 /* USER_STACK에 스택의 PAGE를 생성합니다. 성공하면 true를 반환합니다. */
@@ -804,11 +811,14 @@ setup_stack (struct intr_frame *if_) {
 	bool success = false;
 	void *stack_bottom = (void *) (((uint8_t *) USER_STACK) - PGSIZE);
 
-	/* TODO: stack_bottom에 스택을 매핑하고 즉시 페이지를 요청합니다.
-	 * TODO: 성공하면 rsp를 적절히 설정합니다.
-	 * TODO: 페이지가 스택임을 표시해야 합니다. */
-	/* TODO: 여기에 코드를 작성하세요 */
-
+	/* 스택이 자랄 수 있는 범위 전체를 영역으로 잡아 두고, 인자를 바로
+	 * 쌓아야 하므로 첫 스택 페이지는 즉시 요청합니다. */
+	if (vm_alloc_region ((uint8_t *) USER_STACK - STACK_LIMIT, STACK_LIMIT,
+				VM_ANON | VM_STACK, true, NULL, NULL, 0, 0)
+			&& vm_claim_page (stack_bottom)) {
+		if_->rsp = USER_STACK;
+		success = true;
+	}
 	return success;
 }
 #endif /* VM */
@@ -15,6 +15,12 @@
 #include <string.h>
 #include "threads/palloc.h"
 #include "threads/malloc.h"
+#include "threads/slab.h"
+#include "threads/vaddr.h"
+#ifdef VM
+#include "vm/vm.h"
+#include "userprog/exception.h"
+#endif
 
 void syscall_entry (void);
 void syscall_handler (struct intr_frame *);
@@ -48,9 +54,23 @@ syscall_init (void) {
 			FLAG_IF | FLAG_TF | FLAG_DF | FLAG_IOPL | FLAG_AC | FLAG_NT);
 
 	lock_init(&filesys_lock);
+	lock_set_name(&filesys_lock, "filesys_lock");
 }
 
 
+/* 사용자 포인터 UADDR이 유효한 주소인지 확인합니다.
+ * VM에서는 아직 적재되지 않았거나 스왑 아웃된 페이지도 어떤 영역 안에
+ * 있으면 유효하며, 실제 접근은 페이지 폴트가 처리합니다. */
+static bool
+is_valid_user_addr (const void *uaddr) {
+	if (uaddr == NULL || !is_user_vaddr (uaddr))
+		return false;
+#ifdef VM
+	return spt_find_vma (&thread_current ()->spt, (void *) uaddr) != NULL;
+#else
+	return pml4_get_page (thread_current ()->pml4, uaddr) != NULL;
+#endif
+}
 
 void halt() {
 	power_off();
@@ -113,7 +133,7 @@ int exec (const char *cmd_line) {
 	if (cmd_line == NULL)
 		exit(-1);
 
-	if (pml4_get_page(t->pml4, cmd_line) == NULL)
+	if (!is_valid_user_addr(cmd_line))
 		exit(-1);
 
 	char *cmd_line_copy = palloc_get_page (0); // cmd_line 그냥넣으면 로드할 때 그 주소로 액세스 불가능해서 터짐
@@ -135,7 +155,7 @@ bool create (const char *file, unsigned initial_size) {
 	if (file == NULL)
 		exit(-1);
 
-	if (pml4_get_page(t->pml4, file) == NULL)
+	if (!is_valid_user_addr(file))
 		exit(-1);
 
 	if (strlen(file) == 0)
@@ -150,7 +170,7 @@ bool remove (const char *file) {
 	if (file == NULL)
 		exit(-1);
 
-	if (pml4_get_page(t->pml4, file) == NULL)
+	if (!is_valid_user_addr(file))
 		exit(-1);
 
 	return filesys_remove(file);
@@ -165,7 +185,7 @@ int open (const char *file) {
 	if (file == NULL)
 		exit(-1);
 
-	if (pml4_get_page(t->pml4, file) == NULL)
+	if (!is_valid_user_addr(file))
 		exit(-1);
 
 	if (strlen(file) == 0)
@@ -181,7 +201,7 @@ int open (const char *file) {
 		fd++;
 	}
 	
-	t->fdt[fd] = malloc(sizeof(struct fdt_entry));
+	t->fdt[fd] = kmem_cache_alloc(&fdt_entry_cache);
 	t->fdt[fd]->type = FILE;
 	t->fdt[fd]->entry = opened_file;
 
@@ -208,7 +228,7 @@ void close (int fd) {
 		return -1;
 
 	file_close(t->fdt[fd]->entry);
-	free(t->fdt[fd]);
+	kmem_cache_free(&fdt_entry_cache, t->fdt[fd]);
 	t->fdt[fd] = NULL;
 	
 }
@@ -223,7 +243,7 @@ int read (int fd, const void *buffer, unsigned length) {
 	if (fd == 0)
 		return input_getc();
 	
-	if (pml4_get_page(t->pml4, buffer) == NULL)
+	if (!is_valid_user_addr(buffer))
 		exit(-1);
 
 	if (fd > 2) {
@@ -249,7 +269,7 @@ int write (int fd, const void *buffer, unsigned length) {
 		return length;
 	}
 
-	if (pml4_get_page(t->pml4, buffer) == NULL)
+	if (!is_valid_user_addr(buffer))
 		exit(-1);
 
 	if (fd > 2) {
@@ -285,12 +305,72 @@ unsigned tell (int fd) {
 }
 
 
+#ifdef VM
+void *mmap (void *addr, size_t length, int writable, int fd, off_t offset) {
+	struct thread *t = thread_current();
+
+	if (fd < 3 || fd > 127 || t->fdt[fd] == NULL)
+		return NULL;
+
+	return do_mmap(addr, length, writable, t->fdt[fd]->entry, offset);
+}
+
+void munmap (void *addr) {
+	do_munmap(addr);
+}
+
+int madvise (void *addr, size_t length, int advice) {
+	return vm_madvise(addr, length, advice);
+}
+
+/* 사용자 버퍼 [UADDR, UADDR + SIZE)의 모든 페이지가 쓰기를 허용하는
+ * 영역 안에 있는지 확인합니다. 커널이 읽기 전용 영역에 쓰다 폴트가 나면
+ * 프로세스가 종료되면서 커널이 잡고 있던 자원이 새므로, 쓰기 전에
+ * 확인해야 합니다. */
+static bool
+is_writable_user_buffer (void *uaddr, size_t size) {
+	uint8_t *p = pg_round_down (uaddr);
+	uint8_t *end = (uint8_t *) uaddr + size;
+
+	if (uaddr == NULL || end < (uint8_t *) uaddr || !is_user_vaddr (end - 1))
+		return false;
+	for (; p < end; p += PGSIZE) {
+		struct vm_area *vma = spt_find_vma (&thread_current ()->spt, p);
+
+		if (vma == NULL || !vma->writable)
+			return false;
+	}
+	return true;
+}
+
+int pfstat (struct pfstat *buf) {
+	struct pfstat *snap;
+
+	if (!is_writable_user_buffer(buf, sizeof *buf))
+		exit(-1);
+
+	/* 커널 스택에 두기에는 크므로 힙에 받아 둔 뒤 복사합니다. */
+	snap = malloc(sizeof *snap);
+	if (snap == NULL)
+		return -1;
+	exception_pfstat(snap);
+	memcpy(buf, snap, sizeof *snap);
+	free(snap);
+	return 0;
+}
+#endif
+
+
 /* The main system call interface */
 void
 syscall_handler (struct intr_frame *f UNUSED) {
 	// TODO: Your implementation goes here.
 	// printf ("system call!\n");
 	uint64_t sys_num = f->R.rax; // 시스템 콜 번호 가져오기
+#ifdef VM
+	/* 커널 모드 페이지 폴트에서 스택 성장을 판단할 때 씁니다. */
+	thread_current()->user_rsp = (void *) f->rsp;
+#endif
 	char *file;
 	int fd;
 	/* f에서 전달 받은 argument들을 가져온다. */
@@ -350,6 +430,20 @@ syscall_handler (struct intr_frame *f UNUSED) {
 	case SYS_TELL:
 		f->R.rax = tell(f->R.rdi);
 		break;
+#ifdef VM
+	case SYS_MMAP:
+		f->R.rax = (uint64_t) mmap((void *) f->R.rdi, f->R.rsi, f->R.rdx, f->R.r10, f->R.r8);
+		break;
+	case SYS_MUNMAP:
+		munmap((void *) f->R.rdi);
+		break;
+	case SYS_MADVISE:
+		f->R.rax = madvise((void *) f->R.rdi, f->R.rsi, f->R.rdx);
+		break;
+	case SYS_PFSTAT:
+		f->R.rax = pfstat((struct pfstat *) f->R.rdi);
+		break;
+#endif
 	default:
 		thread_exit ();
 	}
@@ -2,6 +2,13 @@
 
 #include "vm/vm.h"
 #include "devices/disk.h"
+#include <bitmap.h>
+#include <stdio.h>
+#include <string.h>
+#include "threads/malloc.h"
+#include "threads/synch.h"
+#include "threads/vaddr.h"
+#include "vm/zswap.h"
 
 /* DO NOT MODIFY BELOW LINE */
 static struct disk *swap_disk;
@@ -17,36 +24,245 @@ static const struct page_operations anon_ops = {
 	.type = VM_ANON,
 };
 
+/* 페이지 하나를 담는 스왑 슬롯의 섹터 수. */
+#define SECTORS_PER_SLOT (PGSIZE / DISK_SECTOR_SIZE)
+
+/* 한 번에 잡는 스왑 클러스터의 크기 (슬롯). 연달아 축출되는 페이지는
+ * 같은 클러스터 안에서 이어진 슬롯을 받습니다. */
+#define SWAP_CLUSTER 16
+
+/* 스왑 슬롯 사용 여부. 비트 하나가 슬롯 하나입니다.
+ * swap_owner는 각 슬롯에 저장된 페이지입니다.
+ * swap_refs는 각 슬롯을 가리키는 페이지 수입니다. 공유된 프레임을 축출하면
+ * 그 프레임을 매핑했던 페이지가 모두 한 슬롯을 가리킵니다.
+ * swap_lock이 swap_table, swap_owner, swap_refs, 클러스터 상태를 보호합니다.
+ * 디스크 I/O는 락 밖에서 합니다. */
+static struct bitmap *swap_table;
+static struct page **swap_owner;
+static unsigned *swap_refs;
+static struct lock swap_lock;
+
+/* 현재 클러스터에서 다음에 줄 슬롯과 남은 슬롯 수. */
+static size_t cluster_next;
+static size_t cluster_left;
+
+/* 스왑 통계. */
+static uint64_t swap_in_cnt;
+static uint64_t swap_out_cnt;
+static uint64_t cluster_cnt;        /* 새로 잡은 클러스터 수 */
+
 /* Initialize the data for anonymous pages */
 void
 vm_anon_init (void) {
-	/* TODO: Set up the swap_disk. */
-	swap_disk = NULL;
+	size_t slot_cnt = 0;
+
+	/* 스왑 디스크는 채널 1의 슬레이브(hd1:1)입니다. 없으면 슬롯이 0개인
+	 * 것으로 취급해 익명 페이지는 축출되지 않습니다. */
+	swap_disk = disk_get (1, 1);
+	if (swap_disk != NULL)
+		slot_cnt = disk_size (swap_disk) / SECTORS_PER_SLOT;
+	swap_table = bitmap_create (slot_cnt);
+	swap_owner = calloc (slot_cnt, sizeof *swap_owner);
+	swap_refs = calloc (slot_cnt, sizeof *swap_refs);
+	if (swap_table == NULL
+			|| (slot_cnt > 0 && (swap_owner == NULL || swap_refs == NULL)))
+		PANIC ("swap table allocation failed");
+	lock_init (&swap_lock);
+	lock_set_name (&swap_lock, "swap_lock");
+	zswap_init ();
+}
+
+/* PAGE를 담을 스왑 슬롯을 할당해 반환합니다. 슬롯이 없으면 BITMAP_ERROR.
+ *
+ * 현재 클러스터에 남은 슬롯이 있으면 그 다음 슬롯을 줍니다. 다 썼으면
+ * 커서 뒤쪽에서 SWAP_CLUSTER개가 연속으로 비어 있는 구간을 찾아 새
+ * 클러스터로 삼고, 그런 구간이 없을 때만 아무 빈 슬롯이나 씁니다.
+ * 그래서 같은 시계 바늘 회전에서 축출된 페이지들은 디스크에서도 이웃하고,
+ * 스왑 인 때 짧은 순차 읽기로 함께 읽을 수 있습니다.
+ * swap_lock을 쥔 상태에서 호출합니다. */
+static size_t
+swap_slot_alloc (struct page *page) {
+	size_t slot;
+
+	if (cluster_left == 0 || bitmap_test (swap_table, cluster_next)) {
+		slot = bitmap_scan (swap_table, cluster_next, SWAP_CLUSTER, false);
+		if (slot == BITMAP_ERROR)
+			slot = bitmap_scan (swap_table, 0, SWAP_CLUSTER, false);
+		if (slot != BITMAP_ERROR) {
+			cluster_left = SWAP_CLUSTER;
+			cluster_cnt++;
+		} else {
+			slot = bitmap_scan (swap_table, 0, 1, false);
+			if (slot == BITMAP_ERROR)
+				return BITMAP_ERROR;
+			cluster_left = 1;
+		}
+		cluster_next = slot;
+	}
+
+	slot = cluster_next++;
+	cluster_left--;
+	bitmap_mark (swap_table, slot);
+	swap_owner[slot] = page;
+	swap_refs[slot] = 1;
+	return slot;
+}
+
+/* PAGE가 SLOT을 더 쓰지 않습니다. 마지막 페이지였으면 슬롯을 반납합니다.
+ * swap_lock을 쥔 상태에서 호출합니다. */
+static void
+swap_slot_put (size_t slot, struct page *page) {
+	ASSERT (swap_refs[slot] > 0);
+
+	if (--swap_refs[slot] == 0)
+		bitmap_reset (swap_table, slot);
+	if (swap_owner[slot] == page)
+		swap_owner[slot] = NULL;
 }
 
 /* Initialize the file mapping */
 bool
-anon_initializer (struct page *page, enum vm_type type, void *kva) {
+anon_initializer (struct page *page, enum vm_type type UNUSED, void *kva) {
 	/* Set up the handler */
 	page->operations = &anon_ops;
 
 	struct anon_page *anon_page = &page->anon;
+	anon_page->swap_slot = BITMAP_ERROR;
+	anon_page->zentry = NULL;
+	/* KVA가 NULL이면 다른 페이지의 프레임을 공유할 페이지(COW 포크)이므로
+	 * 채울 내용이 없습니다. */
+	if (kva != NULL)
+		memset (kva, 0, PGSIZE);
+	return true;
 }
 
 /* Swap in the page by read contents from the swap disk. */
 static bool
 anon_swap_in (struct page *page, void *kva) {
 	struct anon_page *anon_page = &page->anon;
+	size_t slot;
+
+	/* 압축 스왑 캐시에 있으면 디스크를 읽지 않습니다. */
+	if (zswap_load (page, kva))
+		return true;
+
+	slot = anon_page->swap_slot;
+	if (slot == BITMAP_ERROR)
+		return false;
+
+	for (size_t i = 0; i < SECTORS_PER_SLOT; i++)
+		disk_read (swap_disk, slot * SECTORS_PER_SLOT + i,
+				(uint8_t *) kva + i * DISK_SECTOR_SIZE);
+
+	lock_acquire (&swap_lock);
+	swap_slot_put (slot, page);
+	swap_in_cnt++;
+	lock_release (&swap_lock);
+	anon_page->swap_slot = BITMAP_ERROR;
+	return true;
+}
+
+/* 익명 페이지 PAGE의 내용 KVA를 새 스왑 슬롯에 씁니다. 슬롯이 없으면
+ * false를 반환합니다. */
+bool
+anon_swap_write (struct page *page, const void *kva) {
+	struct anon_page *anon_page = &page->anon;
+	size_t slot;
+
+	lock_acquire (&swap_lock);
+	slot = swap_slot_alloc (page);
+	if (slot != BITMAP_ERROR)
+		swap_out_cnt++;
+	lock_release (&swap_lock);
+	if (slot == BITMAP_ERROR)
+		return false;
+
+	for (size_t i = 0; i < SECTORS_PER_SLOT; i++)
+		disk_write (swap_disk, slot * SECTORS_PER_SLOT + i,
+				(const uint8_t *) kva + i * DISK_SECTOR_SIZE);
+	anon_page->swap_slot = slot;
+	return true;
+}
+
+/* anon_swap_write()로 PAGE를 쓴 슬롯을 SHARER도 가리키게 합니다. 둘은
+ * 축출 직전까지 한 프레임을 공유하던 페이지입니다. */
+void
+anon_swap_share (struct page *page, struct page *sharer) {
+	size_t slot = page->anon.swap_slot;
+
+	ASSERT (slot != BITMAP_ERROR);
+	ASSERT (VM_TYPE (sharer->operations->type) == VM_ANON);
+
+	lock_acquire (&swap_lock);
+	swap_refs[slot]++;
+	lock_release (&swap_lock);
+	sharer->anon.swap_slot = slot;
 }
 
 /* Swap out the page by writing contents to the swap disk. */
 static bool
 anon_swap_out (struct page *page) {
-	struct anon_page *anon_page = &page->anon;
+	/* 압축 스왑 캐시에 넣지 못한 페이지만 디스크에 씁니다. */
+	return zswap_store (page, page->frame->kva)
+		|| anon_swap_write (page, page->frame->kva);
 }
 
 /* Destroy the anonymous page. PAGE will be freed by the caller. */
 static void
 anon_destroy (struct page *page) {
 	struct anon_page *anon_page = &page->anon;
+
+	zswap_invalidate (page);
+	if (anon_page->swap_slot != BITMAP_ERROR) {
+		lock_acquire (&swap_lock);
+		swap_slot_put (anon_page->swap_slot, page);
+		lock_release (&swap_lock);
+		anon_page->swap_slot = BITMAP_ERROR;
+	}
+}
+
+/* 스왑 아웃된 PAGE와 같은 readahead 창(슬롯 번호를 SWAP_READAHEAD로
+ * 정렬한 구간)에 있는 슬롯 중, 같은 프로세스(같은 pml4)의 페이지를
+ * 슬롯 순서대로 최대 MAX개 PAGES에 담고 그 수를 반환합니다. PAGE의 스왑
+ * 인과 함께 읽어 두라는 뜻이며, 스왑 인으로 PAGE의 슬롯이 반납되기 전에
+ * 호출해야 합니다.
+ * 돌려준 페이지는 호출자의 프로세스 것이므로 락을 놓은 뒤에도 다른
+ * 스레드가 해제하지 않습니다. */
+size_t
+anon_swap_readahead (struct page *page, struct page *pages[], size_t max) {
+	size_t slot, first, cnt = 0;
+
+	if (VM_TYPE (page->operations->type) != VM_ANON)
+		return 0;
+	slot = page->anon.swap_slot;
+	if (slot == BITMAP_ERROR)
+		return 0;
+
+	first = slot & ~(size_t) (SWAP_READAHEAD - 1);
+	lock_acquire (&swap_lock);
+	for (size_t s = first; s < first + SWAP_READAHEAD && cnt < max; s++) {
+		struct page *p;
+
+		if (s == slot || s >= bitmap_size (swap_table))
+			continue;
+		p = swap_owner[s];
+		if (p != NULL && p->pml4 == page->pml4)
+			pages[cnt++] = p;
+	}
+	lock_release (&swap_lock);
+	return cnt;
+}
+
+/* 스왑 슬롯 사용량과 입출력 횟수를 출력합니다. */
+void
+swap_print_stats (void) {
+	lock_acquire (&swap_lock);
+	printf ("Swap: %zu/%zu slots in use, %llu swap-ins, "
+			"%llu swap-outs in %llu clusters\n",
+			bitmap_count (swap_table, 0, bitmap_size (swap_table), true),
+			bitmap_size (swap_table),
+			(unsigned long long) swap_in_cnt,
+			(unsigned long long) swap_out_cnt,
+			(unsigned long long) cluster_cnt);
+	lock_release (&swap_lock);
 }
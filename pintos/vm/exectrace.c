@@ -0,0 +1,186 @@
+/* exectrace.c: Prefetch executables' pages from recorded fault traces. */
+
+#include "vm/exectrace.h"
+#include <stdint.h>
+#include <stdio.h>
+#include "filesys/file.h"
+#include "filesys/filesys.h"
+#include "filesys/inode.h"
+#include "threads/malloc.h"
+#include "threads/synch.h"
+#include "threads/thread.h"
+#include "vm/vm.h"
+
+/* 실행 파일 폴트 기록.
+ *
+ * 같은 실행 파일을 exec하면 매번 같은 순서로 세그먼트 페이지에 폴트가
+ * 납니다. 그래서 실행 파일을 처음 실행할 때 세그먼트에서 읽어 온 처음
+ * exec_trace_pages개 페이지의 주소를 기록해 두었다가 프로세스가 끝나면
+ * 기록 파일(TRACE_FILE)에 씁니다. 다음에 같은 실행 파일을 exec하면
+ * load()가 사용자 모드로 넘어가기 전에 기록된 페이지를 주소 순으로 한꺼번에
+ * 올려, 첫 시스템 콜까지 폴트를 한 번씩 기다리지 않게 합니다.
+ *
+ * 기록 파일은 TRACE_SLOTS개의 고정 크기 칸으로 이루어지고, 실행 파일은
+ * inode 섹터 번호로 칸을 고릅니다. 칸이 겹치면 나중 기록이 덮어씁니다.
+ * 기록 파일의 섹터는 0이 될 수 없으므로 0으로 채운 칸은 비어 있습니다.
+ * 실행 파일이 바뀌어 기록이 맞지 않더라도 영역 밖 주소는 건너뛰므로
+ * 미리 읽기가 조금 헛될 뿐입니다.
+ *
+ * trace_lock이 기록 파일과 통계를 보호합니다. */
+
+#define TRACE_FILE ".exectrace"
+#define TRACE_SLOTS 64
+
+/* 실행 파일 하나의 기록. 기록 파일의 한 칸입니다. */
+struct exec_trace {
+	uint32_t sector;                /* 실행 파일의 inode 섹터 */
+	uint32_t cnt;                   /* 기록한 페이지 수 */
+	void *pages[EXEC_TRACE_MAX];    /* 읽어 온 순서대로의 페이지 주소 */
+};
+
+unsigned exec_trace_pages = 0;
+static struct lock trace_lock;
+static uint64_t trace_write_cnt;        /* 기록 파일에 쓴 기록 수 */
+static uint64_t trace_hit_cnt;          /* 기록으로 미리 읽은 exec 수 */
+static uint64_t trace_page_cnt;         /* 기록으로 미리 올린 페이지 수 */
+
+void
+exec_trace_init (void) {
+	lock_init (&trace_lock);
+}
+
+static off_t
+trace_slot_ofs (uint32_t sector) {
+	return (off_t) (sector % TRACE_SLOTS) * sizeof (struct exec_trace);
+}
+
+/* SECTOR의 기록을 TR로 읽습니다. 기록이 있으면 true를 반환합니다.
+ * trace_lock을 쥔 상태에서 호출합니다. */
+static bool
+trace_read (uint32_t sector, struct exec_trace *tr) {
+	struct file *file = filesys_open (TRACE_FILE);
+	bool found;
+
+	if (file == NULL)
+		return false;
+	found = file_read_at (file, tr, sizeof *tr, trace_slot_ofs (sector))
+			== sizeof *tr
+		&& tr->sector == sector
+		&& tr->cnt > 0 && tr->cnt <= EXEC_TRACE_MAX;
+	file_close (file);
+	return found;
+}
+
+/* TR을 기록 파일에 씁니다. 기록 파일이 없으면 만듭니다.
+ * trace_lock을 쥔 상태에서 호출합니다. */
+static void
+trace_write (const struct exec_trace *tr) {
+	struct file *file = filesys_open (TRACE_FILE);
+
+	if (file == NULL) {
+		if (!filesys_create (TRACE_FILE,
+					TRACE_SLOTS * sizeof (struct exec_trace)))
+			return;
+		file = filesys_open (TRACE_FILE);
+		if (file == NULL)
+			return;
+	}
+	if (file_write_at (file, tr, sizeof *tr, trace_slot_ofs (tr->sector))
+			== sizeof *tr)
+		trace_write_cnt++;
+	file_close (file);
+}
+
+/* 주소 순으로 정렬합니다. 많아야 EXEC_TRACE_MAX개라 삽입 정렬로 충분합니다. */
+static void
+sort_pages (void *pages[], size_t cnt) {
+	for (size_t i = 1; i < cnt; i++) {
+		void *p = pages[i];
+		size_t j = i;
+
+		for (; j > 0 && pages[j - 1] > p; j--)
+			pages[j] = pages[j - 1];
+		pages[j] = p;
+	}
+}
+
+/* 방금 적재한 실행 파일 EXE의 기록이 있으면 그 페이지들을 올리고, 없으면
+ * 현재 프로세스에서 기록을 시작합니다. load()가 세그먼트와 스택을 만든
+ * 뒤에 호출합니다. */
+void
+exec_trace_start (struct file *exe) {
+	struct thread *t = thread_current ();
+	struct exec_trace *tr;
+	uint32_t sector;
+	size_t loaded;
+
+	if (exec_trace_pages == 0)
+		return;
+	tr = malloc (sizeof *tr);
+	if (tr == NULL)
+		return;
+	sector = inode_get_inumber (file_get_inode (exe));
+
+	lock_acquire (&trace_lock);
+	if (!trace_read (sector, tr)) {
+		lock_release (&trace_lock);
+		tr->sector = sector;
+		tr->cnt = 0;
+		t->exec_trace = tr;
+		return;
+	}
+	lock_release (&trace_lock);
+
+	sort_pages (tr->pages, tr->cnt);
+	loaded = vm_populate (tr->pages, tr->cnt);
+	free (tr);
+
+	lock_acquire (&trace_lock);
+	trace_hit_cnt++;
+	trace_page_cnt += loaded;
+	lock_release (&trace_lock);
+}
+
+/* 실행 파일 세그먼트의 PAGE를 파일에서 읽어 왔음을 기록합니다. 기록 중인
+ * 프로세스가 직접 읽어 온 페이지만 기록합니다. */
+void
+exec_trace_record (struct page *page) {
+	struct thread *t = thread_current ();
+	struct exec_trace *tr = t->exec_trace;
+
+	if (tr == NULL || page->pml4 != t->pml4
+			|| tr->cnt >= exec_trace_pages || tr->cnt >= EXEC_TRACE_MAX)
+		return;
+	tr->pages[tr->cnt++] = page->va;
+}
+
+/* 현재 프로세스의 기록을 끝내고 기록 파일에 씁니다. 프로세스가 끝나거나
+ * 다른 프로그램을 exec할 때 호출합니다. */
+void
+exec_trace_finish (void) {
+	struct thread *t = thread_current ();
+	struct exec_trace *tr = t->exec_trace;
+
+	if (tr == NULL)
+		return;
+	t->exec_trace = NULL;
+	if (tr->cnt > 0) {
+		lock_acquire (&trace_lock);
+		trace_write (tr);
+		lock_release (&trace_lock);
+	}
+	free (tr);
+}
+
+void
+exec_trace_print_stats (void) {
+	if (exec_trace_pages == 0)
+		return;
+	lock_acquire (&trace_lock);
+	printf ("Exec trace: %llu traces written, %llu execs prefetched, "
+			"%llu pages prefetched\n",
+			(unsigned long long) trace_write_cnt,
+			(unsigned long long) trace_hit_cnt,
+			(unsigned long long) trace_page_cnt);
+	lock_release (&trace_lock);
+}
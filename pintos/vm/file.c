@@ -1,6 +1,11 @@
 /* file.c: Implementation of memory backed file object (mmaped object). */
 
 #include "vm/vm.h"
+#include <mman.h>
+#include <round.h>
+#include <string.h>
+#include "threads/mmu.h"
+#include "threads/vaddr.h"
 
 static bool file_backed_swap_in (struct page *page, void *kva);
 static bool file_backed_swap_out (struct page *page);
@@ -21,38 +26,113 @@ vm_file_init (void) {
 
 /* Initialize the file backed page */
 bool
-file_backed_initializer (struct page *page, enum vm_type type, void *kva) {
+file_backed_initializer (struct page *page, enum vm_type type UNUSED, void *kva UNUSED) {
 	/* Set up the handler */
 	page->operations = &file_ops;
 
+	/* 위치 정보는 뒤이어 호출되는 lazy_load_file()이 영역에서 계산합니다. */
 	struct file_page *file_page = &page->file;
+	file_page->ofs = 0;
+	file_page->read_bytes = 0;
+	return true;
+}
+
+/* PAGE의 파일 내용을 KVA에 읽고 나머지를 0으로 채웁니다. */
+static bool
+file_page_read (struct page *page, void *kva) {
+	struct file_page *fp = &page->file;
+
+	if (file_read_at (page->vma->file, kva, fp->read_bytes, fp->ofs)
+			!= (off_t) fp->read_bytes)
+		return false;
+	memset ((uint8_t *) kva + fp->read_bytes, 0, PGSIZE - fp->read_bytes);
+	return true;
+}
+
+/* mmap 페이지의 첫 폴트에서 호출됩니다. aux는 페이지가 속한 영역이며,
+ * 영역에서 이 페이지의 위치를 계산해 두고 내용을 읽어 옵니다. */
+static bool
+lazy_load_file (struct page *page, void *aux) {
+	struct vm_area *vma = aux;
+
+	vm_area_page (vma, page->va, &page->file.ofs, &page->file.read_bytes);
+	return file_page_read (page, page->frame->kva);
 }
 
 /* Swap in the page by read contents from the file. */
 static bool
 file_backed_swap_in (struct page *page, void *kva) {
-	struct file_page *file_page UNUSED = &page->file;
+	return file_page_read (page, kva);
+}
+
+/* 메모리에 있는 PAGE가 수정되었으면 파일에 다시 씁니다. 매핑이 남아 있는
+ * 채로 불릴 수도 있으므로(vm_cleaner), 쓰는 도중에 사용자가 고친 내용을
+ * 놓치지 않도록 더티 비트를 먼저 지우고 씁니다. 그 사이에 고쳐졌다면
+ * 더티 비트가 다시 켜져 나중에 한 번 더 씁니다. */
+void
+file_page_writeback (struct page *page) {
+	struct file_page *file_page = &page->file;
+
+	if (pml4_is_dirty (page->pml4, page->va)) {
+		pml4_set_dirty (page->pml4, page->va, false);
+		file_write_at (page->vma->file, page->frame->kva,
+				file_page->read_bytes, file_page->ofs);
+	}
 }
 
 /* Swap out the page by writeback contents to the file. */
 static bool
 file_backed_swap_out (struct page *page) {
-	struct file_page *file_page UNUSED = &page->file;
+	file_page_writeback (page);
+	return true;
 }
 
 /* Destory the file backed page. PAGE will be freed by the caller. */
 static void
 file_backed_destroy (struct page *page) {
-	struct file_page *file_page UNUSED = &page->file;
+	if (page->frame != NULL)
+		file_page_writeback (page);
 }
 
-/* Do the mmap */
+/* Do the mmap
+ * WRITABLE에 MAP_POPULATE를 함께 주면 돌아오기 전에 매핑한 페이지를
+ * 모두 읽어 오므로, 이후의 접근은 폴트를 일으키지 않습니다. 메모리가
+ * 모자라 다 올리지 못해도 매핑은 성공합니다. */
 void *
 do_mmap (void *addr, size_t length, int writable,
 		struct file *file, off_t offset) {
+	bool populate = (writable & MAP_POPULATE) != 0;
+	size_t page_cnt = DIV_ROUND_UP (length, PGSIZE);
+	off_t file_len = file_length (file);
+	uint8_t *upage = addr;
+	size_t read_bytes;
+
+	if (addr == NULL || pg_ofs (addr) != 0 || length == 0
+			|| offset < 0 || pg_ofs (offset) != 0 || file_len == 0)
+		return NULL;
+	if (!is_user_vaddr (addr) || !is_user_vaddr (upage + page_cnt * PGSIZE - 1)
+			|| upage + page_cnt * PGSIZE < upage)
+		return NULL;
+
+	/* 영역 하나만 만들고 페이지는 폴트가 날 때 만듭니다. 다른 영역과
+	 * 겹치면 vm_alloc_region()이 실패합니다. */
+	read_bytes = offset < file_len ? (size_t) (file_len - offset) : 0;
+	if (read_bytes > page_cnt * PGSIZE)
+		read_bytes = page_cnt * PGSIZE;
+	writable &= ~MAP_POPULATE;
+	if (!vm_alloc_region (addr, page_cnt * PGSIZE, VM_FILE, writable != 0,
+				lazy_load_file, file, offset, read_bytes))
+		return NULL;
+	if (populate)
+		vm_populate_range (addr, page_cnt * PGSIZE);
+	return addr;
 }
 
 /* Do the munmap */
 void
 do_munmap (void *addr) {
+	struct vm_area *vma = spt_find_vma (&thread_current ()->spt, addr);
+
+	if (vma != NULL && vma->start == addr && VM_TYPE (vma->type) == VM_FILE)
+		vm_dealloc_region (vma);
 }
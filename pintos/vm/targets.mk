@@ -2,4 +2,6 @@ vm_SRC = vm/vm.c          # Main api proxy
 vm_SRC += vm/uninit.c     # Uninitialized page
 vm_SRC += vm/anon.c       # Anonymous page
 vm_SRC += vm/file.c       # File mapped page
+vm_SRC += vm/zswap.c      # Compressed swap cache
+vm_SRC += vm/exectrace.c  # Exec-time prefetch from fault traces
 vm_SRC += vm/inspect.c    # Testing utility
@@ -62,7 +62,8 @@ uninit_initialize (struct page *page, void *kva) {
  * PAGE will be freed by the caller. */
 static void
 uninit_destroy (struct page *page) {
-	struct uninit_page *uninit UNUSED = &page->uninit;
-	/* TODO: Fill this function.
-	 * TODO: If you don't have anything to do, just return. */
+	struct uninit_page *uninit = &page->uninit;
+
+	/* aux는 페이지가 속한 영역이므로 영역이 없어질 때 함께 정리됩니다. */
+	uninit->aux = NULL;
 }
@@ -1,10 +1,169 @@
 /* vm.c: Generic interface for virtual memory objects. */
 
+#include <mman.h>
+#include <round.h>
+#include <stdio.h>
+#include <string.h>
 #include "threads/malloc.h"
+#include "threads/mmu.h"
+#include "threads/slab.h"
+#include "threads/synch.h"
+#include "threads/vaddr.h"
+#include "devices/timer.h"
+#include "filesys/file.h"
+#include "filesys/inode.h"
 #include "vm/vm.h"
+#include "vm/exectrace.h"
 #include "vm/inspect.h"
+#include "vm/zswap.h"
 #include "lib/kernel/hash.h"
+#include "intrinsic.h"
 
+/* Caches for struct page, struct frame and struct vm_area. */
+static struct kmem_cache vm_page_cache;
+static struct kmem_cache vm_frame_cache;
+static struct kmem_cache vm_area_cache;
+
+/* 프레임 테이블.
+ *
+ * 사용자 풀에서 받은 모든 프레임이 frame_table에 들어 있고, clock_hand가
+ * 이 리스트를 원형으로 돌면서 축출할 프레임을 고릅니다 (vm_get_victim).
+ * frame_lock은 frame_table, clock_hand, frame_cnt, 프레임과 페이지 사이의
+ * 연결(frame->page, page->frame), pinned를 보호합니다.
+ *
+ * 프레임 하나를 여러 페이지가 매핑할 수 있습니다 (포크의 COW, KSM, 실행
+ * 파일 텍스트 캐시). 프레임은 자기를 매핑한 모든 페이지, 곧 모든 (pml4,
+ * va) 쌍을 역매핑(rmap) 목록으로 압니다. 목록은 frame->page에서 시작해
+ * page->next_sharer로 이어지고, 각 페이지는 자기를 가리키는 앞 링크
+ * (pprev_sharer)를 알아 어느 페이지든 O(1)에 뺄 수 있습니다. 그래서
+ * 공유된 프레임도 모든 매핑을 끊고 축출할 수 있습니다.
+ *
+ * 디스크 I/O는 frame_lock을 놓고 합니다. 그동안 프레임은 pinned 상태로
+ * 남아 있어 다른 스레드가 축출하지 않습니다. 적재나 축출 중인(pinned)
+ * 페이지에 접근하려는 스레드는 frame_cond에서 기다립니다. */
+static struct list frame_table;
+static struct list_elem *clock_hand;
+static size_t frame_cnt;
+static struct lock frame_lock;
+static struct condition frame_cond;
+
+/* 축출 통계. frame_lock이 보호합니다. */
+static uint64_t evict_cnt;              /* 축출한 프레임 수 */
+static uint64_t clean_drop_cnt;         /* 디스크에 쓰지 않고 버린 프레임 수 */
+static uint64_t dirty_writeback_cnt;    /* 디스크에 쓴 뒤 축출한 프레임 수 */
+static uint64_t readahead_cnt;          /* 스왑 readahead로 올린 페이지 수 */
+static uint64_t shared_evict_cnt;       /* 축출한 공유 프레임 수 */
+static uint64_t rmap_unmap_cnt;         /* 축출에서 끊은 매핑 수 */
+static uint64_t tlb_flush_cnt;          /* 축출에서 TLB 전체를 비운 횟수 */
+
+/* 더티 페이지 청소 데몬 (vm_cleaner).
+ * 축출이 일어나면 깨어나 시계 바늘 앞쪽의 프레임을 훑으며 수정된 파일
+ * 페이지를 미리 파일에 씁니다. 바늘 앞에 곧바로 회수할 수 있는 깨끗한
+ * 프레임이 vm_clean_watermark개 모이면 멈춥니다. 그래서 축출은 대부분
+ * 쓰기 없이 깨끗한 프레임을 고르고, 폴트 지연에 디스크 쓰기가 끼지
+ * 않습니다. 커널 옵션 -clean-watermark=N으로 정하며 0이면 끕니다. */
+#define CLEANER_SCAN_MAX 256            /* 한 번에 훑는 최대 프레임 수 */
+unsigned vm_clean_watermark = 16;
+static struct condition cleaner_cond;   /* 축출이 일어났음을 데몬에 알림 */
+static bool cleaner_kick;               /* 데몬이 할 일이 있음 */
+static uint64_t cleaner_pass_cnt;       /* 데몬이 훑은 횟수 */
+static uint64_t cleaner_write_cnt;      /* 데몬이 미리 쓴 페이지 수 */
+static void vm_cleaner (void *aux);
+
+/* 미리 읽기 스레드 (vm_prefetcher).
+ * madvise(MADV_WILLNEED)가 요청한 범위의 페이지를 요청한 프로세스 대신
+ * 백그라운드에서 올립니다. 요청은 prefetch_queue에
+ * 쌓이고, prefetch_lock이 큐와 prefetch_busy, prefetch_stop을 보호합니다.
+ * 프로세스가 끝나거나 exec하면 prefetch_cancel()이 그 프로세스의 요청을
+ * 지우고, 처리 중인 요청이 멈출 때까지 기다립니다. */
+struct prefetch_req {
+	struct supplemental_page_table *spt;  /* 요청한 프로세스의 테이블 */
+	uint8_t *start;                       /* 범위의 시작 */
+	uint8_t *end;                         /* 범위의 끝 */
+	struct list_elem elem;                /* prefetch_queue의 원소 */
+};
+static struct list prefetch_queue;
+static struct lock prefetch_lock;
+static struct condition prefetch_cond;  /* 큐나 prefetch_busy가 바뀜 */
+static struct supplemental_page_table *prefetch_busy; /* 처리 중인 테이블 */
+static bool prefetch_stop;              /* 처리 중인 요청을 그만둘 것 */
+static uint64_t prefetch_req_cnt;       /* 받은 요청 수 */
+static uint64_t prefetch_page_cnt;      /* 미리 올린 페이지 수 */
+static uint64_t drop_behind_cnt;        /* 순차 접근에서 먼저 놓아 준 프레임 수 */
+static void vm_prefetcher (void *aux);
+
+/* 같은 페이지 병합 데몬 (vm_ksm).
+ * vm_ksm_sleep_ms마다 깨어나 자기 바늘(ksm_hand) 앞의 프레임 vm_ksm_pages개를
+ * 훑습니다. 익명 페이지 프레임의 내용 해시가 지난번 방문 때와 같으면 자주
+ * 바뀌지 않는 페이지로 보고, 같은 해시의 대표 프레임을 ksm_table에서
+ * 찾습니다. 내용이 바이트 단위로 같으면 두 프레임을 하나로 합쳐 모든
+ * 페이지가 읽기 전용으로 공유하게 합니다. 포크의 COW와 같은 공유 목록을
+ * 쓰므로, 합친 페이지에 쓰면 vm_handle_wp()가 사본을 만들어 갈라 놓습니다.
+ * frame_lock이 ksm_table, ksm_hand, 프레임의 ksm_* 멤버를 보호합니다.
+ * 커널 옵션 -ksm=N으로 켜고 -ksm-sleep=MS로 주기를 정합니다. */
+unsigned vm_ksm_pages = 0;
+unsigned vm_ksm_sleep_ms = 20;
+static struct hash ksm_table;           /* 내용 해시 -> 대표 프레임 */
+static struct list_elem *ksm_hand;
+static uint64_t ksm_scan_cnt;           /* 훑은 프레임 수 */
+static uint64_t ksm_merge_cnt;          /* 합쳐서 돌려준 프레임 수 */
+static uint64_t ksm_cycles;             /* 데몬이 쓴 TSC 사이클 합 */
+static hash_hash_func ksm_hash;
+static hash_less_func ksm_less;
+static void vm_ksm (void *aux);
+
+/* fault-around. 파일에서 읽어 오는 페이지에 폴트가 나면 같은 영역의 뒤따르는
+ * 페이지를 영역별 창 크기만큼 함께 올립니다. 창의 최대 크기는 커널
+ * 옵션 -fault-around=N으로 정하며 1 이하이면 끕니다. */
+unsigned vm_fault_around_max = 8;
+static uint64_t file_fault_cnt;         /* 파일에서 읽어 온 페이지 폴트 수 */
+static uint64_t fault_around_cnt;       /* fault-around로 미리 올린 페이지 수 */
+
+/* 포크와 COW 통계. frame_lock이 보호합니다. */
+static uint64_t fork_cnt;               /* 복제한 주소 공간 수 */
+static uint64_t fork_pages;             /* 복제한 페이지 수 */
+static uint64_t fork_cycles;            /* 복제에 걸린 TSC 사이클 합 */
+static uint64_t cow_share_cnt;          /* 포크에서 복사 대신 공유한 프레임 수 */
+static uint64_t cow_copy_cnt;           /* 쓰기 폴트에서 공유를 깨고 복사한 수 */
+static uint64_t cow_reuse_cnt;          /* 마지막 공유자라 복사 없이 쓰기를 허용한 수 */
+
+/* 공유 제로 페이지. 한 번도 쓰지 않은 익명 페이지(스택, BSS)에 읽기
+ * 폴트가 나면 프레임을 할당하는 대신 이 페이지를 읽기 전용으로 매핑하고,
+ * 첫 쓰기 폴트에서 자기 프레임으로 바꿉니다. 커널 풀에서 할당하므로
+ * 프레임 테이블에 들어가지 않고 축출되지도 않습니다. */
+static void *zero_page;
+static size_t zero_mapped_cnt;          /* 지금 제로 페이지를 매핑한 페이지 수 */
+static uint64_t zero_fault_cnt;         /* 제로 페이지로 처리한 읽기 폴트 수 */
+static uint64_t zero_break_cnt;         /* 쓰기로 제로 페이지를 벗어난 수 */
+
+/* 실행 파일 텍스트 프레임 캐시.
+ * 실행 파일의 읽기 전용 세그먼트 페이지는 내용이 언제나 파일과 같으므로,
+ * 같은 실행 파일을 돌리는 프로세스들이 한 프레임을 읽기 전용으로 공유합니다.
+ * 페이지를 처음 올린 프레임을 (실행 파일의 inode 섹터, 파일 오프셋, 읽은
+ * 바이트 수)로 캐시에 등록하고, 다른 프로세스가 같은 페이지에 폴트를 내면
+ * 읽지 않고 그 프레임의 공유 목록에 들어갑니다. 공유 목록이 참조 수
+ * 역할을 합니다. 마지막 프로세스가 끝나도 프레임은 주인 없이(page ==
+ * NULL) 캐시에 남아 다음 exec가 그대로 씁니다. 이런 프레임은 축출 때
+ * 가장 먼저 회수됩니다. 텍스트 프레임을 축출할 때는 공유하는 모든 매핑을
+ * 끊고 쓰지 않고 버리며, 페이지는 다음 폴트에서 캐시나 파일에서 다시
+ * 올립니다. 실행 파일에 쓰거나 실행 파일을 지우면 vm_text_invalidate()가
+ * 캐시를 비웁니다. frame_lock이 캐시를 보호합니다.
+ * 폴트마다 찾으므로 프레임은 키 하나로 text_frames에서 바로 찾고, 실행
+ * 파일별 목록은 그 파일의 캐시를 비울 때만 씁니다. */
+struct text_file {
+	disk_sector_t sector;       /* 실행 파일의 inode 섹터 */
+	struct list frames;         /* 캐시된 프레임들 (frame->text_elem) */
+	struct hash_elem elem;      /* text_files의 원소 */
+};
+static struct hash text_files;          /* 섹터 -> 실행 파일 */
+static struct hash text_frames;         /* (섹터, 오프셋, 길이) -> 프레임 */
+static size_t text_cached_cnt;          /* 지금 캐시에 있는 프레임 수 */
+static uint64_t text_share_cnt;         /* 읽지 않고 캐시에서 매핑한 수 */
+static uint64_t text_evict_cnt;         /* 쓰지 않고 버린 텍스트 프레임 수 */
+static hash_hash_func text_file_hash;
+static hash_less_func text_file_less;
+static hash_hash_func text_frame_hash;
+static hash_less_func text_frame_less;
 
 /* Initializes the virtual memory subsystem by invoking each subsystem's
  * intialize codes. */
@@ -17,7 +176,29 @@ vm_init (void) {
 #endif
 	register_inspect_intr ();
 	/* DO NOT MODIFY UPPER LINES. */
-	/* TODO: Your code goes here. */
+	exec_trace_init ();
+	kmem_cache_init (&vm_page_cache, "vm_page", sizeof (struct page), NULL);
+	kmem_cache_init (&vm_frame_cache, "vm_frame", sizeof (struct frame), NULL);
+	kmem_cache_init (&vm_area_cache, "vm_area", sizeof (struct vm_area), NULL);
+	list_init (&frame_table);
+	clock_hand = NULL;
+	lock_init (&frame_lock);
+	lock_set_name (&frame_lock, "frame_lock");
+	cond_init (&frame_cond);
+	cond_init (&cleaner_cond);
+	zero_page = palloc_get_page (PAL_ASSERT | PAL_ZERO);
+	if (vm_clean_watermark > 0)
+		thread_create ("vm_cleaner", PRI_DEFAULT, vm_cleaner, NULL);
+	list_init (&prefetch_queue);
+	lock_init (&prefetch_lock);
+	lock_set_name (&prefetch_lock, "prefetch_lock");
+	cond_init (&prefetch_cond);
+	thread_create ("vm_prefetcher", PRI_DEFAULT, vm_prefetcher, NULL);
+	hash_init (&ksm_table, ksm_hash, ksm_less, NULL);
+	hash_init (&text_files, text_file_hash, text_file_less, NULL);
+	hash_init (&text_frames, text_frame_hash, text_frame_less, NULL);
+	if (vm_ksm_pages > 0)
+		thread_create ("vm_ksm", PRI_MIN, vm_ksm, NULL);
 }
 
 /* Get the type of the page. This function is useful if you want to know the
@@ -39,9 +220,60 @@ static struct frame *vm_get_victim (void);
 static bool vm_do_claim_page (struct page *page);
 static struct frame *vm_evict_frame (void);
 
+/* VMA 안의 UPAGE에 TYPE 타입의 uninit 페이지를 만들어 SPT에 넣고
+ * 반환합니다. 이미 페이지가 있거나 메모리가 모자라면 NULL을 반환합니다. */
+static struct page *
+spt_alloc_page (struct supplemental_page_table *spt, struct vm_area *vma,
+		enum vm_type type, void *upage, bool writable,
+		vm_initializer *init, void *aux) {
+	bool (*initializer) (struct page *, enum vm_type, void *);
+	struct page *page;
+
+	switch (VM_TYPE (type)) {
+		case VM_ANON:
+			initializer = anon_initializer;
+			break;
+		case VM_FILE:
+			initializer = file_backed_initializer;
+			break;
+		default:
+			return NULL;
+	}
+
+	page = kmem_cache_alloc (&vm_page_cache);
+	if (page == NULL)
+		return NULL;
+	uninit_new (page, upage, init, type, aux, initializer);
+	page->vma = vma;
+	page->pml4 = thread_current ()->pml4;
+	page->writable = writable;
+
+	if (!spt_insert_page (spt, page)) {
+		kmem_cache_free (&vm_page_cache, page);
+		return NULL;
+	}
+	list_push_back (&vma->pages, &page->vma_elem);
+	return page;
+}
+
+/* VMA 안의 주소 VA에 처음 폴트가 났을 때 영역의 정보로 페이지를 만듭니다.
+ * 파일 내용이 끝난 뒤의 익명 페이지(BSS)는 0으로 채우기만 하면 됩니다. */
+static struct page *
+vma_alloc_page (struct supplemental_page_table *spt, struct vm_area *vma,
+		void *va) {
+	vm_initializer *init = vma->init;
+
+	va = pg_round_down (va);
+	if (VM_TYPE (vma->type) == VM_ANON
+			&& (size_t) ((uint8_t *) va - vma->start) >= vma->read_bytes)
+		init = NULL;
+	return spt_alloc_page (spt, vma, vma->type, va, vma->writable, init, vma);
+}
+
 /* Create the pending page object with initializer. If you want to create a
  * page, do not create it directly and make it through this function or
- * `vm_alloc_page`. */
+ * `vm_alloc_page`.
+ * UPAGE는 vm_alloc_region()으로 만든 영역 안에 있어야 합니다. */
 bool
 vm_alloc_page_with_initializer (enum vm_type type, void *upage, bool writable,
 		vm_initializer *init, void *aux) {
@@ -49,32 +281,26 @@ vm_alloc_page_with_initializer (enum vm_type type, void *upage, bool writable,
 	ASSERT (VM_TYPE(type) != VM_UNINIT)
 
 	struct supplemental_page_table *spt = &thread_current ()->spt;
+	struct vm_area *vma = spt_find_vma (spt, upage);
 
-	/* Check wheter the upage is already occupied or not. */
-	if (spt_find_page (spt, upage) == NULL) {
-		/* TODO: Create the page, fetch the initialier according to the VM type,
-		 * TODO: and then create "uninit" page struct by calling uninit_new. You
-		 * TODO: should modify the field after calling the uninit_new. */
-
-		/* TODO: Insert the page into the spt. */
-	}
-err:
-	return false;
+	if (vma == NULL)
+		return false;
+	return spt_alloc_page (spt, vma, type, upage, writable, init, aux) != NULL;
 }
 
-/* Find VA from spt and return page. On error, return NULL. 
+/* Find VA from spt and return page. On error, return NULL.
 보조 페이지 테이블에서, 주어진 가상 주소 va에 대응되는 struct page를 찾아 반환
 찾지 못하면 NULL을 반환*/
 struct page *
 spt_find_page (struct supplemental_page_table *spt UNUSED, void *va UNUSED) {
-	
+
 	//va를 비교 기준으로 사용할 것이기 때문에, va 값만 세팅된 임시 page 객체를 생성
 	struct page page;
-	page.va = va;
+	page.va = pg_round_down (va);
 
 	//find_hash 함수를 사용해서 spt에서 같은 게 있는지 찾는다
 	struct hash_elem *elem = hash_find(&spt->spt_hash,&page.hash_elem);
-	
+
 	//있으면 page를 반환 없으면 null을 반환
 	if (elem == NULL){
 		return NULL;
@@ -90,7 +316,7 @@ bool
 spt_insert_page (struct supplemental_page_table *spt UNUSED,
 		struct page *page UNUSED) {
 	int succ = false;
-	
+
 	if (hash_insert(&spt->spt_hash, &page->hash_elem) == NULL){
 		succ = true;
 	}
@@ -99,16 +325,487 @@ spt_insert_page (struct supplemental_page_table *spt UNUSED,
 
 void
 spt_remove_page (struct supplemental_page_table *spt, struct page *page) {
+	hash_delete (&spt->spt_hash, &page->hash_elem);
+	list_remove (&page->vma_elem);
 	vm_dealloc_page (page);
+}
+
+/* 영역 A가 영역 B보다 앞에 있으면 true를 반환합니다. 서로 겹치는 두
+ * 영역은 같은 것으로 취급되므로 avl_find()로 겹치는 영역을 찾을 수
+ * 있습니다. */
+static bool
+vma_less (const struct avl_elem *a_, const struct avl_elem *b_,
+		void *aux UNUSED) {
+	const struct vm_area *a = avl_entry (a_, struct vm_area, elem);
+	const struct vm_area *b = avl_entry (b_, struct vm_area, elem);
+
+	return a->end <= b->start;
+}
+
+/* VA를 포함하는 영역을 반환합니다. 없으면 NULL을 반환합니다. */
+struct vm_area *
+spt_find_vma (struct supplemental_page_table *spt, void *va) {
+	uint8_t *upage = pg_round_down (va);
+	struct vm_area key = { .start = upage, .end = upage + PGSIZE };
+	struct avl_elem *e;
+
+	e = avl_find (&spt->vmas, &key.elem);
+	return e != NULL ? avl_entry (e, struct vm_area, elem) : NULL;
+}
+
+/* 현재 프로세스에 [START, START + LENGTH) 영역을 만듭니다. 페이지는 하나도
+ * 만들지 않으며, 영역 안에서 폴트가 날 때 TYPE 타입으로 만듭니다. FILE이
+ * 있으면 따로 열어 두고, START부터 READ_BYTES 바이트는 FILE의 오프셋
+ * OFS부터 INIT으로 읽어 옵니다. 다른 영역과 겹치거나 메모리가 모자라면
+ * false를 반환합니다. */
+bool
+vm_alloc_region (void *start, size_t length, enum vm_type type,
+		bool writable, vm_initializer *init, struct file *file, off_t ofs,
+		size_t read_bytes) {
+	struct supplemental_page_table *spt = &thread_current ()->spt;
+	struct vm_area *vma;
+
+	ASSERT (pg_ofs (start) == 0);
+	ASSERT (length > 0 && length % PGSIZE == 0);
+	ASSERT (read_bytes <= length);
+
+	vma = kmem_cache_alloc (&vm_area_cache);
+	if (vma == NULL)
+		return false;
+	vma->start = start;
+	vma->end = vma->start + length;
+	vma->type = type;
+	vma->writable = writable;
+	vma->init = init;
+	vma->file = NULL;
+	vma->ofs = ofs;
+	vma->read_bytes = read_bytes;
+	vma->fa.next = NULL;
+	vma->fa.window = 4;
+	vma->advice = MADV_NORMAL;
+	list_init (&vma->pages);
+
+	lock_acquire (&spt->lock);
+	if (avl_insert (&spt->vmas, &vma->elem) != NULL)
+		goto fail;
+	if (file != NULL && (vma->file = file_reopen (file)) == NULL) {
+		avl_remove (&spt->vmas, &vma->elem);
+		goto fail;
+	}
+	lock_release (&spt->lock);
 	return true;
+
+fail:
+	lock_release (&spt->lock);
+	kmem_cache_free (&vm_area_cache, vma);
+	return false;
+}
+
+/* 현재 프로세스의 영역 VMA를 없앱니다. 영역에서 만들어진 페이지를 모두
+ * 해제하고(수정된 파일 페이지는 파일에 다시 씀) 파일을 닫습니다. */
+void
+vm_dealloc_region (struct vm_area *vma) {
+	struct supplemental_page_table *spt = &thread_current ()->spt;
+
+	lock_acquire (&spt->lock);
+	while (!list_empty (&vma->pages))
+		spt_remove_page (spt, list_entry (list_front (&vma->pages),
+					struct page, vma_elem));
+	avl_remove (&spt->vmas, &vma->elem);
+	lock_release (&spt->lock);
+	file_close (vma->file);
+	kmem_cache_free (&vm_area_cache, vma);
+}
+
+/* VMA 안의 주소 VA에 있는 페이지가 파일에서 읽을 위치를 *OFS에, 읽을
+ * 바이트 수를 *READ_BYTES에 담습니다. 나머지는 0으로 채웁니다. */
+void
+vm_area_page (const struct vm_area *vma, const void *va,
+		off_t *ofs, size_t *read_bytes) {
+	size_t offset = (const uint8_t *) pg_round_down (va) - vma->start;
+
+	*ofs = vma->ofs + offset;
+	*read_bytes = 0;
+	if (offset < vma->read_bytes)
+		*read_bytes = vma->read_bytes - offset < PGSIZE
+			? vma->read_bytes - offset : PGSIZE;
+}
+
+/* 시계 바늘이 가리키는 프레임을 반환하고 바늘을 한 칸 옮깁니다.
+ * frame_table이 비어 있지 않아야 하며 frame_lock을 쥔 상태에서 호출합니다. */
+static struct frame *
+clock_advance (void) {
+	struct frame *f;
+
+	if (clock_hand == NULL || clock_hand == list_end (&frame_table))
+		clock_hand = list_begin (&frame_table);
+	f = list_entry (clock_hand, struct frame, elem);
+	clock_hand = list_next (clock_hand);
+	return f;
+}
+
+/* F를 프레임 테이블에서 뺍니다. 바늘이 F를 가리키면 다음 프레임으로 옮깁니다.
+ * frame_lock을 쥔 상태에서 호출합니다. */
+static void ksm_forget (struct frame *f);
+static void text_forget (struct frame *f);
+
+static void
+frame_table_remove (struct frame *f) {
+	if (clock_hand == &f->elem)
+		clock_hand = list_next (clock_hand);
+	if (ksm_hand == &f->elem)
+		ksm_hand = list_next (ksm_hand);
+	ksm_forget (f);
+	text_forget (f);
+	list_remove (&f->elem);
+	frame_cnt--;
+}
+
+/* F를 축출하려면 디스크에 써야 하는지 반환합니다. 파일 페이지는 수정된
+ * 경우에만 쓰면 되지만, 익명 페이지는 내용을 보관할 곳이 스왑뿐이라
+ * 항상 써야 합니다. */
+static bool page_is_text (struct page *page);
+
+static bool
+frame_is_dirty (struct frame *f) {
+	struct page *page = f->page;
+
+	if (page_get_type (page) == VM_FILE) {
+		for (struct page *p = f->page; p != NULL; p = p->next_sharer)
+			if (pml4_is_dirty (p->pml4, p->va))
+				return true;
+		return false;
+	}
+	return !page_is_text (page);
+}
+
+/* F를 매핑한 페이지 중 하나라도 최근에 접근되었는지 반환하고, 모든
+ * 페이지의 접근 비트를 끕니다. frame_lock을 쥔 상태에서 호출합니다. */
+static bool
+frame_test_and_clear_accessed (struct frame *f) {
+	bool accessed = false;
+
+	for (struct page *p = f->page; p != NULL; p = p->next_sharer)
+		if (pml4_is_accessed (p->pml4, p->va)) {
+			pml4_set_accessed (p->pml4, p->va, false);
+			accessed = true;
+		}
+	return accessed;
+}
+
+/* F를 둘 이상의 페이지가 공유하는지 반환합니다. frame_lock을 쥔 상태에서
+ * 호출합니다. */
+static bool
+frame_is_shared (struct frame *f) {
+	return f->mapcount > 1;
+}
+
+/* PAGE를 F의 rmap에 넣습니다. 매핑은 호출자가 합니다.
+ * frame_lock을 쥔 상태에서 호출합니다. */
+static void
+rmap_add (struct frame *f, struct page *page) {
+	page->next_sharer = f->page;
+	if (f->page != NULL)
+		f->page->pprev_sharer = &page->next_sharer;
+	page->pprev_sharer = &f->page;
+	f->page = page;
+	page->frame = f;
+	f->mapcount++;
+}
+
+/* PAGE를 F의 rmap에서 뺍니다. 매핑은 호출자가 끊습니다.
+ * frame_lock을 쥔 상태에서 호출합니다. */
+static void
+rmap_remove (struct frame *f, struct page *page) {
+	ASSERT (page->frame == f);
+
+	*page->pprev_sharer = page->next_sharer;
+	if (page->next_sharer != NULL)
+		page->next_sharer->pprev_sharer = page->pprev_sharer;
+	page->next_sharer = NULL;
+	page->pprev_sharer = NULL;
+	page->frame = NULL;
+	f->mapcount--;
+}
+
+/* F를 매핑한 모든 PTE를 없는 것으로 표시하고, 그 PTE들의 접근/더티 비트를
+ * 합쳐 반환합니다. PTE의 나머지 비트는 남겨 둡니다. 현재 주소 공간의
+ * 매핑이 여럿이면 항목마다 invlpg하지 않고 TLB를 한 번에 비웁니다. 다른
+ * 주소 공간의 옛 TLB 항목은 문맥 교환 때 비워집니다.
+ * frame_lock을 쥔 상태에서 호출합니다. */
+static uint64_t
+rmap_unmap (struct frame *f) {
+	uint64_t *active = ptov (rcr3 ());
+	uint64_t bits = 0;
+	void *local = NULL;
+	size_t local_cnt = 0;
+
+	for (struct page *p = f->page; p != NULL; p = p->next_sharer) {
+		uint64_t *pte = pml4e_walk (p->pml4, (uint64_t) p->va, false);
+
+		if (pte == NULL || (*pte & PTE_P) == 0)
+			continue;
+		bits |= *pte & (PTE_A | PTE_D);
+		*pte &= ~PTE_P;
+		rmap_unmap_cnt++;
+		if (p->pml4 == active) {
+			local = p->va;
+			local_cnt++;
+		}
+	}
+	if (local_cnt == 1)
+		invlpg ((uint64_t) local);
+	else if (local_cnt > 1) {
+		lcr3 (rcr3 ());
+		tlb_flush_cnt++;
+	}
+	return bits;
+}
+
+/* rmap_unmap()으로 끊은 F의 매핑을 되돌립니다. 공유 중이면 모두 읽기
+ * 전용으로 매핑합니다. frame_lock을 쥔 상태에서 호출합니다. */
+static void
+rmap_remap (struct frame *f) {
+	bool shared = frame_is_shared (f);
+
+	for (struct page *p = f->page; p != NULL; p = p->next_sharer)
+		pml4_set_page (p->pml4, p->va, f->kva, p->writable && !shared);
+}
+
+/* PAGE의 가상 주소를 KVA에 매핑합니다. 이미 있는 매핑을 바꾸는 경우를 위해
+ * 현재 주소 공간이면 TLB의 옛 항목을 무효화합니다. */
+static bool
+page_map (struct page *page, void *kva, bool writable) {
+	if (!pml4_set_page (page->pml4, page->va, kva, writable))
+		return false;
+	if (rcr3 () == vtop (page->pml4))
+		invlpg ((uint64_t) page->va);
+	return true;
+}
+
+/* PAGE가 아직 한 번도 쓰이지 않아 내용이 전부 0인 익명 페이지인지
+ * 반환합니다. */
+static bool
+page_is_zero_fill (struct page *page) {
+	return VM_TYPE (page->operations->type) == VM_UNINIT
+		&& VM_TYPE (page->uninit.type) == VM_ANON
+		&& page->uninit.init == NULL;
+}
+
+/* PAGE가 지금 공유 제로 페이지를 매핑하고 있는지 반환합니다. */
+static bool
+page_is_zero_mapped (struct page *page) {
+	return page_is_zero_fill (page)
+		&& pml4_get_page (page->pml4, page->va) == zero_page;
+}
+
+/* PAGE가 실행 파일의 읽기 전용 세그먼트에서 파일 내용이 있는 페이지인지
+ * 반환합니다. 이런 페이지는 쓸 수 없으므로 내용이 언제나 파일과 같습니다. */
+static bool
+page_is_text (struct page *page) {
+	struct vm_area *vma = page->vma;
+
+	return VM_TYPE (vma->type) == VM_ANON && !vma->writable
+		&& vma->file != NULL && vma->init != NULL
+		&& (size_t) ((uint8_t *) page->va - vma->start) < vma->read_bytes;
+}
+
+static uint64_t
+text_file_hash (const struct hash_elem *e, void *aux UNUSED) {
+	const struct text_file *tf = hash_entry (e, struct text_file, elem);
+
+	return hash_int (tf->sector);
+}
+
+static bool
+text_file_less (const struct hash_elem *a, const struct hash_elem *b,
+		void *aux UNUSED) {
+	return hash_entry (a, struct text_file, elem)->sector
+		< hash_entry (b, struct text_file, elem)->sector;
+}
+
+static uint64_t
+text_frame_hash (const struct hash_elem *e, void *aux UNUSED) {
+	const struct frame *f = hash_entry (e, struct frame, text_hash_elem);
+
+	return hash_int (f->text_sector) ^ hash_int (f->text_ofs);
+}
+
+static bool
+text_frame_less (const struct hash_elem *a_, const struct hash_elem *b_,
+		void *aux UNUSED) {
+	const struct frame *a = hash_entry (a_, struct frame, text_hash_elem);
+	const struct frame *b = hash_entry (b_, struct frame, text_hash_elem);
+
+	if (a->text_sector != b->text_sector)
+		return a->text_sector < b->text_sector;
+	if (a->text_ofs != b->text_ofs)
+		return a->text_ofs < b->text_ofs;
+	return a->text_len < b->text_len;
+}
+
+/* 실행 파일 SECTOR의 캐시를 반환합니다. 없으면 NULL을 반환합니다.
+ * frame_lock을 쥔 상태에서 호출합니다. */
+static struct text_file *
+text_file_find (disk_sector_t sector) {
+	struct text_file key = { .sector = sector };
+	struct hash_elem *e = hash_find (&text_files, &key.elem);
+
+	return e != NULL ? hash_entry (e, struct text_file, elem) : NULL;
+}
+
+/* 텍스트 PAGE의 캐시 키를 구합니다. */
+static disk_sector_t
+text_key (struct page *page, off_t *ofs, size_t *len) {
+	vm_area_page (page->vma, page->va, ofs, len);
+	return inode_get_inumber (file_get_inode (page->vma->file));
+}
+
+/* 텍스트 PAGE의 내용을 캐시한 프레임을 반환합니다. 없으면 NULL을
+ * 반환합니다. frame_lock을 쥔 상태에서 호출합니다. */
+static struct frame *
+text_lookup (struct page *page) {
+	struct frame key;
+	struct hash_elem *e;
+
+	key.text_sector = text_key (page, &key.text_ofs, &key.text_len);
+	e = hash_find (&text_frames, &key.text_hash_elem);
+	return e != NULL ? hash_entry (e, struct frame, text_hash_elem) : NULL;
+}
+
+/* 방금 텍스트 PAGE의 내용을 읽어 온 프레임 F를 캐시에 넣습니다. 같은
+ * 내용의 프레임이 이미 있으면 넣지 않습니다. frame_lock을 쥔 상태에서
+ * 호출합니다. */
+static void
+text_insert (struct frame *f, struct page *page) {
+	struct text_file *tf;
+
+	if (f->text != NULL)
+		return;
+	f->text_sector = text_key (page, &f->text_ofs, &f->text_len);
+	if (hash_find (&text_frames, &f->text_hash_elem) != NULL)
+		return;
+	tf = text_file_find (f->text_sector);
+	if (tf == NULL) {
+		tf = malloc (sizeof *tf);
+		if (tf == NULL)
+			return;
+		tf->sector = f->text_sector;
+		list_init (&tf->frames);
+		hash_insert (&text_files, &tf->elem);
+	}
+	list_push_back (&tf->frames, &f->text_elem);
+	hash_insert (&text_frames, &f->text_hash_elem);
+	f->text = tf;
+	text_cached_cnt++;
+}
+
+/* F를 텍스트 캐시에서 뺍니다. frame_lock을 쥔 상태에서 호출합니다. */
+static void
+text_forget (struct frame *f) {
+	struct text_file *tf = f->text;
+
+	if (tf == NULL)
+		return;
+	list_remove (&f->text_elem);
+	hash_delete (&text_frames, &f->text_hash_elem);
+	f->text = NULL;
+	text_cached_cnt--;
+	if (list_empty (&tf->frames)) {
+		hash_delete (&text_files, &tf->elem);
+		free (tf);
+	}
+}
+
+/* 다른 프로세스가 이미 올린 프레임이 있으면 텍스트 PAGE를 그 프레임에
+ * 읽기 전용으로 매핑하고 true를 반환합니다. 그 프레임을 누가 올리는
+ * 중이면 끝나기를 기다립니다. */
+static bool
+text_share (struct page *page) {
+	struct frame *frame;
+
+	lock_acquire (&frame_lock);
+	while ((frame = text_lookup (page)) != NULL && frame->pinned)
+		cond_wait (&frame_cond, &frame_lock);
+	if (frame == NULL) {
+		lock_release (&frame_lock);
+		return false;
+	}
+
+	/* 처음 접근하는 페이지면 파일을 읽지 않고 익명 페이지로 바꿉니다. */
+	if (VM_TYPE (page->operations->type) == VM_UNINIT)
+		anon_initializer (page, VM_ANON, NULL);
+	rmap_add (frame, page);
+
+	/* 매핑하기 전에 축출되지 않도록 락을 쥔 채 매핑합니다. */
+	if (!page_map (page, frame->kva, false)) {
+		rmap_remove (frame, page);
+		lock_release (&frame_lock);
+		return false;
+	}
+	text_share_cnt++;
+	lock_release (&frame_lock);
+	return true;
+}
+
+/* 실행 파일 SECTOR에 쓰거나 SECTOR를 지울 때 그 실행 파일의 캐시를
+ * 비웁니다. 아무도 매핑하지 않은 프레임은 돌려주고, 매핑된 프레임은
+ * 캐시에서만 빼서 마지막 페이지가 없어질 때 해제되게 합니다. */
+void
+vm_text_invalidate (disk_sector_t sector) {
+	struct text_file *tf;
+
+	lock_acquire (&frame_lock);
+	while ((tf = text_file_find (sector)) != NULL) {
+		struct frame *f = list_entry (list_front (&tf->frames),
+				struct frame, text_elem);
+
+		if (f->page == NULL && !f->pinned) {
+			frame_table_remove (f);
+			palloc_free_page (f->kva);
+			kmem_cache_free (&vm_frame_cache, f);
+		} else
+			text_forget (f);
+	}
+	lock_release (&frame_lock);
 }
 
 /* Get the struct frame, that will be evicted. */
 static struct frame *
 vm_get_victim (void) {
 	struct frame *victim = NULL;
-	 /* TODO: The policy for eviction is up to you. */
 
+	/* 두 번째 기회(second chance) 시계 알고리즘에 깨끗한 페이지 우선을
+	 * 더했습니다. 바늘이 지나가는 프레임의 접근 비트가 켜져 있으면 끄고
+	 * 넘어갑니다. 접근 비트가 꺼진 프레임 중 깨끗한 것은 바로 고르고,
+	 * 더러운 것은 첫 후보만 기억해 둡니다. 한 바퀴를 돌 때까지 깨끗한
+	 * 프레임이 없으면 기억해 둔 더러운 후보를 고릅니다. 후보도 없으면
+	 * 방금 접근 비트를 모두 껐으므로 두 번째 바퀴에서 반드시 찾습니다.
+	 * 여러 페이지가 공유하는 프레임은 어느 한 매핑이라도 접근했으면 최근에
+	 * 쓰인 것으로 봅니다. 아무도 매핑하지 않은 텍스트 캐시 프레임은 바로
+	 * 고릅니다. pinned인 프레임만 남았으면 NULL을 반환합니다.
+	 * frame_lock을 쥔 상태에서 호출합니다. */
+	for (size_t i = 0; frame_cnt > 0 && i < 2 * frame_cnt; i++) {
+		if (victim != NULL && i >= frame_cnt)
+			break;
+
+		struct frame *f = clock_advance ();
+		struct page *page = f->page;
+
+		if (f->pinned)
+			continue;
+		if (page == NULL) {
+			if (f->text != NULL)
+				return f;
+			continue;
+		}
+		if (frame_test_and_clear_accessed (f))
+			continue;
+		if (!frame_is_dirty (f))
+			return f;
+		if (victim == NULL)
+			victim = f;
+	}
 	return victim;
 }
 
@@ -116,110 +813,1237 @@ vm_get_victim (void) {
  * Return NULL on error.*/
 static struct frame *
 vm_evict_frame (void) {
-	struct frame *victim UNUSED = vm_get_victim ();
-	/* TODO: swap out the victim and return the evicted frame. */
+	struct frame *victim;
+	struct page *page, *p;
+	bool dirty, shared, success;
+	uint64_t bits;
+
+	lock_acquire (&frame_lock);
+	victim = vm_get_victim ();
+	if (victim == NULL) {
+		lock_release (&frame_lock);
+		return NULL;
+	}
+	page = victim->page;
+	victim->pinned = true;
+
+	/* 내보내는 동안 사용자가 페이지를 고치지 못하도록 모든 매핑을 먼저
+	 * 끊습니다. 이후 이 페이지들에 폴트를 낸 스레드는 축출이 끝날 때까지
+	 * 기다립니다. */
+	bits = rmap_unmap (victim);
+	shared = frame_is_shared (victim);
+	if (shared)
+		shared_evict_cnt++;
+
+	if (page == NULL || page_is_text (page)) {
+		/* 실행 파일 텍스트는 파일에서 다시 읽을 수 있으므로 쓰지 않고
+		 * 버립니다. */
+		while ((p = victim->page) != NULL)
+			rmap_remove (victim, p);
+		text_forget (victim);
+		evict_cnt++;
+		clean_drop_cnt++;
+		text_evict_cnt++;
+		cleaner_kick = true;
+		cond_signal (&cleaner_cond, &frame_lock);
+		cond_broadcast (&frame_cond, &frame_lock);
+		lock_release (&frame_lock);
+		return victim;
+	}
+	dirty = page_get_type (page) != VM_FILE || (bits & PTE_D) != 0;
+	lock_release (&frame_lock);
+
+	/* 공유된 익명 프레임은 한 번만 써서 모든 페이지가 같은 슬롯을
+	 * 가리키게 합니다. */
+	ASSERT (!shared || page_get_type (page) == VM_ANON);
+	success = shared ? anon_swap_write (page, victim->kva) : swap_out (page);
+
+	lock_acquire (&frame_lock);
+	if (success) {
+		while ((p = victim->page) != NULL) {
+			if (p != page)
+				anon_swap_share (page, p);
+			rmap_remove (victim, p);
+		}
+		ksm_forget (victim);
+		evict_cnt++;
+		if (dirty)
+			dirty_writeback_cnt++;
+		else
+			clean_drop_cnt++;
+		/* 깨끗한 프레임 하나를 썼으니 청소 데몬이 다시 채우게 합니다. */
+		cleaner_kick = true;
+		cond_signal (&cleaner_cond, &frame_lock);
+	} else {
+		/* 스왑 공간이 모자랍니다. 매핑을 되돌립니다. */
+		rmap_remap (victim);
+		victim->pinned = false;
+		victim = NULL;
+	}
+	cond_broadcast (&frame_cond, &frame_lock);
+	lock_release (&frame_lock);
+	return victim;
+}
+
+/* 시계 바늘 앞쪽부터 최대 CLEANER_SCAN_MAX개의 프레임을 훑으며, 수정된
+ * 파일 페이지를 파일에 써서 깨끗하게 만듭니다. 이미 깨끗하고 최근에
+ * 접근되지 않아 바늘이 오면 바로 회수할 수 있는 프레임이
+ * vm_clean_watermark개가 되면 멈춥니다. 최근에 접근된 프레임은 바늘이
+ * 한 번 더 기회를 줄 것이라 건드리지 않습니다. 익명 페이지는 스왑
+ * 슬롯을 미리 잡아 둘 곳이 없으므로 청소하지 않습니다.
+ * frame_lock을 쥔 상태에서 호출하며, 쓰는 동안에는 프레임을 고정하고
+ * 락을 놓습니다. */
+static void
+cleaner_pass (void) {
+	struct list_elem *e = clock_hand;
+	size_t clean = 0;
+
+	for (size_t i = 0; i < frame_cnt && i < CLEANER_SCAN_MAX
+			&& clean < vm_clean_watermark; i++) {
+		struct frame *f;
+		struct page *page;
+
+		if (e == NULL || e == list_end (&frame_table))
+			e = list_begin (&frame_table);
+		f = list_entry (e, struct frame, elem);
+		e = list_next (e);
+		page = f->page;
+
+		if (f->pinned || page == NULL || frame_is_shared (f)
+				|| pml4_is_accessed (page->pml4, page->va))
+			continue;
+		if (!frame_is_dirty (f)) {
+			clean++;
+			continue;
+		}
+		if (page_get_type (page) != VM_FILE)
+			continue;
+
+		/* 이 스레드는 사용자 주소 공간을 쓰지 않으므로 PAGE의 TLB 항목은
+		 * 문맥 교환 때 이미 비워졌습니다. 더티 비트를 지우면 다음 쓰기에서
+		 * 다시 켜집니다. */
+		f->pinned = true;
+		lock_release (&frame_lock);
+		file_page_writeback (page);
+		lock_acquire (&frame_lock);
+		f->pinned = false;
+		cond_broadcast (&frame_cond, &frame_lock);
+
+		/* 고정해 둔 동안 F는 프레임 테이블에 남아 있었습니다. */
+		e = list_next (&f->elem);
+		cleaner_write_cnt++;
+		clean++;
+	}
+	cleaner_pass_cnt++;
+}
+
+/* 더티 페이지 청소 데몬. 축출이 일어날 때마다 한 번씩 훑습니다. */
+static void
+vm_cleaner (void *aux UNUSED) {
+	lock_acquire (&frame_lock);
+	for (;;) {
+		while (!cleaner_kick)
+			cond_wait (&cleaner_cond, &frame_lock);
+		cleaner_kick = false;
+		cleaner_pass ();
+	}
+}
+
+static uint64_t
+ksm_hash (const struct hash_elem *e, void *aux UNUSED) {
+	return hash_entry (e, struct frame, ksm_elem)->ksm_sum;
+}
+
+static bool
+ksm_less (const struct hash_elem *a, const struct hash_elem *b,
+		void *aux UNUSED) {
+	return hash_entry (a, struct frame, ksm_elem)->ksm_sum
+		< hash_entry (b, struct frame, ksm_elem)->ksm_sum;
+}
+
+/* F가 ksm_table의 대표이면 뺍니다. frame_lock을 쥔 상태에서 호출합니다. */
+static void
+ksm_forget (struct frame *f) {
+	if (f->ksm_listed) {
+		hash_delete (&ksm_table, &f->ksm_elem);
+		f->ksm_listed = false;
+	}
+}
+
+/* F가 KSM으로 합칠 수 있는 프레임인지 반환합니다. 실행 파일 텍스트는
+ * 이미 텍스트 캐시로 공유되므로 건드리지 않습니다. */
+static bool
+ksm_mergeable (struct frame *f) {
+	return !f->pinned && f->page != NULL
+		&& VM_TYPE (f->page->operations->type) == VM_ANON
+		&& !page_is_text (f->page);
+}
+
+/* F를 공유하는 모든 페이지를 WRITABLE이 허용하는 대로 다시 매핑합니다.
+ * WRITABLE이 false이면 모두 읽기 전용이 됩니다. */
+static void
+ksm_map_sharers (struct frame *f, bool writable) {
+	for (struct page *p = f->page; p != NULL; p = p->next_sharer)
+		page_map (p, f->kva, writable && p->writable);
+}
+
+/* 내용이 같은 두 프레임 KEEP과 DROP을 합쳐 DROP을 돌려줍니다. 비교하는
+ * 동안 사용자가 내용을 바꾸지 못하도록 양쪽을 먼저 읽기 전용으로 매핑하고,
+ * 다르면 원래대로 되돌립니다. 합쳤으면 true를 반환합니다.
+ * frame_lock을 쥔 상태에서 호출합니다. */
+static bool
+ksm_merge (struct frame *keep, struct frame *drop) {
+	bool keep_shared = frame_is_shared (keep);
+	bool drop_shared = frame_is_shared (drop);
+	struct page *p;
+
+	ksm_map_sharers (keep, false);
+	ksm_map_sharers (drop, false);
+	if (memcmp (keep->kva, drop->kva, PGSIZE)) {
+		ksm_map_sharers (keep, !keep_shared);
+		ksm_map_sharers (drop, !drop_shared);
+		return false;
+	}
+
+	/* DROP의 rmap에 있는 페이지를 모두 KEEP으로 옮깁니다. */
+	while ((p = drop->page) != NULL) {
+		rmap_remove (drop, p);
+		rmap_add (keep, p);
+		page_map (p, keep->kva, false);
+	}
+	frame_table_remove (drop);
+	palloc_free_page (drop->kva);
+	kmem_cache_free (&vm_frame_cache, drop);
+	ksm_merge_cnt++;
+	return true;
+}
+
+/* 프레임 F를 살펴봅니다. 지난번 방문 뒤로 내용이 바뀌지 않았으면 같은
+ * 해시의 대표와 합쳐 보고, 합치지 못하면 F가 새 대표가 됩니다.
+ * frame_lock을 쥔 상태에서 호출하며, F가 해제될 수 있습니다. */
+static void
+ksm_scan_frame (struct frame *f) {
+	struct hash_elem *e;
+	uint64_t sum;
+
+	if (!ksm_mergeable (f))
+		return;
+	ksm_scan_cnt++;
+
+	/* 대표로 있는 동안 내용이 바뀌었을 수 있으므로 빼고 다시 넣습니다. */
+	ksm_forget (f);
+	sum = hash_bytes (f->kva, PGSIZE);
+	if (sum != f->ksm_sum) {
+		f->ksm_sum = sum;
+		return;
+	}
 
-	return NULL;
+	e = hash_insert (&ksm_table, &f->ksm_elem);
+	if (e != NULL) {
+		struct frame *rep = hash_entry (e, struct frame, ksm_elem);
+
+		if (ksm_mergeable (rep) && ksm_merge (rep, f))
+			return;
+		hash_replace (&ksm_table, &f->ksm_elem);
+		rep->ksm_listed = false;
+	}
+	f->ksm_listed = true;
+}
+
+/* 같은 페이지 병합 데몬. 한 번에 vm_ksm_pages개의 프레임을 훑고 잠듭니다.
+ * 프레임 사이마다 frame_lock을 놓아 폴트 처리가 오래 기다리지 않게 합니다.
+ * 훑는 동안 사용자 주소 공간을 쓰지 않으므로 다른 프로세스의 매핑을
+ * 바꾸어도 TLB에 옛 항목이 남지 않습니다. */
+static void
+vm_ksm (void *aux UNUSED) {
+	for (;;) {
+		uint64_t start;
+
+		timer_msleep (vm_ksm_sleep_ms);
+		start = rdtsc ();
+		lock_acquire (&frame_lock);
+		for (unsigned i = 0; i < vm_ksm_pages && i < frame_cnt; i++) {
+			struct frame *f;
+
+			if (ksm_hand == NULL || ksm_hand == list_end (&frame_table))
+				ksm_hand = list_begin (&frame_table);
+			f = list_entry (ksm_hand, struct frame, elem);
+			ksm_hand = list_next (ksm_hand);
+			ksm_scan_frame (f);
+
+			lock_release (&frame_lock);
+			lock_acquire (&frame_lock);
+		}
+		ksm_cycles += rdtsc () - start;
+		lock_release (&frame_lock);
+	}
 }
 
 /* palloc() and get frame. If there is no available page, evict the page
  * and return it. This always return valid address. That is, if the user pool
  * memory is full, this function evicts the frame to get the available memory
- * space.*/
+ * space.
+ * 반환된 프레임은 pinned 상태입니다. 축출할 수 있는 프레임도 없으면
+ * NULL을 반환합니다. */
 static struct frame *
 vm_get_frame (void) {
 	struct frame *frame = NULL;
-	/* TODO: Fill this function. */
+	void *kva = palloc_get_page (PAL_USER);
+
+	if (kva != NULL) {
+		frame = kmem_cache_alloc (&vm_frame_cache);
+		if (frame == NULL) {
+			palloc_free_page (kva);
+			return NULL;
+		}
+		frame->kva = kva;
+		frame->page = NULL;
+		frame->mapcount = 0;
+		frame->pinned = true;
+		frame->ksm_listed = false;
+		frame->text = NULL;
+
+		/* 새 프레임은 바늘 바로 뒤에 넣어 가장 늦게 검사받게 합니다. */
+		lock_acquire (&frame_lock);
+		if (clock_hand != NULL)
+			list_insert (clock_hand, &frame->elem);
+		else
+			list_push_back (&frame_table, &frame->elem);
+		frame_cnt++;
+		lock_release (&frame_lock);
+	} else
+		frame = vm_evict_frame ();
 
-	ASSERT (frame != NULL);
-	ASSERT (frame->page == NULL);
+	ASSERT (frame == NULL || frame->page == NULL);
+	if (frame != NULL)
+		frame->ksm_sum = 0;
 	return frame;
 }
 
+/* FRAME의 고정을 풀고 기다리는 스레드를 깨웁니다. */
+static void
+vm_unpin_frame (struct frame *frame) {
+	lock_acquire (&frame_lock);
+	frame->pinned = false;
+	cond_broadcast (&frame_cond, &frame_lock);
+	lock_release (&frame_lock);
+}
+
+/* FRAME을 페이지와 프레임 테이블에서 떼어내고 사용자 풀에 돌려줍니다.
+ * FRAME은 호출자가 고정해 둔 상태여야 합니다. */
+static void
+vm_free_frame (struct frame *frame) {
+	struct page *page;
+
+	ASSERT (frame->pinned);
+
+	lock_acquire (&frame_lock);
+	while ((page = frame->page) != NULL) {
+		pml4_clear_page (page->pml4, page->va);
+		rmap_remove (frame, page);
+	}
+	frame_table_remove (frame);
+	cond_broadcast (&frame_cond, &frame_lock);
+	lock_release (&frame_lock);
+
+	palloc_free_page (frame->kva);
+	kmem_cache_free (&vm_frame_cache, frame);
+}
+
+/* PAGE가 적재나 축출 중이면 끝날 때까지 기다린 뒤, PAGE가 메모리에
+ * 있으면 그 프레임을, 없으면 NULL을 반환합니다.
+ * frame_lock을 쥔 상태에서 호출합니다. */
+static struct frame *
+page_wait_frame (struct page *page) {
+	while (page->frame != NULL && page->frame->pinned)
+		cond_wait (&frame_cond, &frame_lock);
+	return page->frame;
+}
+
+/* PAGE를 메모리에 올리고 그 프레임을 고정해서 반환합니다.
+ * 실패하면 NULL을 반환합니다. */
+static struct frame *
+vm_pin_page (struct page *page) {
+	struct frame *frame;
+
+	for (;;) {
+		lock_acquire (&frame_lock);
+		frame = page_wait_frame (page);
+		if (frame != NULL)
+			frame->pinned = true;
+		lock_release (&frame_lock);
+		if (frame != NULL)
+			return frame;
+
+		/* 올린 직후 다른 스레드가 축출할 수 있으므로 다시 확인합니다. */
+		if (!vm_do_claim_page (page))
+			return NULL;
+	}
+}
+
 /* Growing the stack. */
 static void
 vm_stack_growth (void *addr UNUSED) {
+	vm_alloc_page (VM_ANON | VM_STACK, pg_round_down (addr), true);
+}
+
+/* ADDR에 대한 폴트가 스택 성장으로 처리할 접근인지 반환합니다.
+ * 스택 영역 안이라도 rsp 아래는 허용하지 않습니다. PUSH 명령은 rsp보다
+ * 8바이트 아래를 먼저 건드릴 수 있습니다. */
+static bool
+is_stack_access (void *addr, void *rsp) {
+	return (uint8_t *) addr >= (uint8_t *) USER_STACK - STACK_LIMIT
+		&& (uint8_t *) addr < (uint8_t *) USER_STACK
+		&& (uint8_t *) addr >= (uint8_t *) rsp - 8;
+}
+
+/* 폴트가 난 페이지와 함께 올릴 이웃 페이지 PAGES[]를 차례로 올리고 실제로
+ * 올린 수를 반환합니다. 이미 메모리에 있는 페이지는 건너뛰고, 프레임을
+ * 얻지 못하면 멈춥니다. 올린 페이지는 접근 비트가 꺼진 채 매핑되므로
+ * 쓰이지 않으면 다음 바퀴에서 먼저 축출됩니다. */
+static size_t
+vm_claim_around (struct page *pages[], size_t cnt) {
+	size_t claimed = 0;
+
+	for (size_t i = 0; i < cnt; i++) {
+		struct frame *frame;
+
+		lock_acquire (&frame_lock);
+		frame = page_wait_frame (pages[i]);
+		lock_release (&frame_lock);
+		if (frame != NULL)
+			continue;
+		if (!vm_do_claim_page (pages[i]))
+			break;
+		claimed++;
+	}
+	return claimed;
+}
+
+/* 메모리에 없는 PAGE를 올리려면 파일에서 읽어 와야 하는지 반환합니다.
+ * 아직 적재되지 않은 파일 내용 페이지와 축출된 파일 페이지가 그렇습니다. */
+static bool
+page_reads_file (struct page *page) {
+	switch (VM_TYPE (page->operations->type)) {
+		case VM_UNINIT:
+			return page->uninit.init != NULL;
+		case VM_FILE:
+			return true;
+		default:
+			return false;
+	}
+}
+
+/* 파일에서 읽어 올 PAGE에 폴트가 났을 때 함께 올릴 뒤따르는 페이지를
+ * PAGES[]에 담고 그 수를 반환합니다. 아직 만들어지지 않은 페이지는
+ * 영역의 정보로 만듭니다.
+ *
+ * 같은 영역 안에서 파일 내용이 있는 페이지만 고릅니다. 창 크기는 영역마다
+ * 따로 조절합니다. 직전 창의 바로 다음 페이지에서 폴트가 나면 순차 접근으로
+ * 보고 두 배로 늘리고, 다른 곳이면 절반으로 줄입니다. */
+static size_t
+vm_fault_around (struct page *page, struct page *pages[]) {
+	struct supplemental_page_table *spt = &thread_current ()->spt;
+	struct vm_area *vma = page->vma;
+	struct fault_around *fa = &vma->fa;
+	unsigned max = vm_fault_around_max < FAULT_AROUND_MAX
+		? vm_fault_around_max : FAULT_AROUND_MAX;
+	size_t cnt = 0;
+
+	if (!page_reads_file (page))
+		return 0;
+	lock_acquire (&frame_lock);
+	file_fault_cnt++;
+	lock_release (&frame_lock);
+
+	/* madvise()로 알린 접근 방식이 있으면 창을 조절하지 않습니다. */
+	if (vma->advice == MADV_RANDOM)
+		return 0;
+	if (vma->advice == MADV_SEQUENTIAL)
+		fa->window = FAULT_AROUND_MAX;
+	else {
+		if (max <= 1)
+			return 0;
+		if (fa->window > max)
+			fa->window = max;
+		if (page->va == fa->next)
+			fa->window = fa->window * 2 < max ? fa->window * 2 : max;
+		else if (fa->next != NULL && fa->window > 1)
+			fa->window /= 2;
+	}
+
+	for (unsigned k = 1; k < fa->window; k++) {
+		uint8_t *va = (uint8_t *) page->va + k * PGSIZE;
+		struct page *q;
+
+		if (va >= vma->end || (size_t) (va - vma->start) >= vma->read_bytes)
+			break;
+		q = spt_find_page (spt, va);
+		if (q == NULL)
+			q = vma_alloc_page (spt, vma, va);
+		if (q == NULL)
+			break;
+		/* 이미 올라와 익명 페이지가 된 것은 건너뜁니다. */
+		if (!page_reads_file (q))
+			continue;
+		pages[cnt++] = q;
+	}
+	fa->next = (uint8_t *) page->va + (cnt + 1) * PGSIZE;
+	return cnt;
 }
 
 /* Handle the fault on write_protected page */
+/* 쓰기 가능한 PAGE가 포크 뒤 읽기 전용으로 공유되고 있어 난 폴트입니다.
+ * 다른 공유자가 남아 있으면 새 프레임에 사본을 만들어 옮겨 가고, PAGE가
+ * 마지막 공유자면 복사 없이 쓰기를 허용합니다. */
 static bool
 vm_handle_wp (struct page *page UNUSED) {
+	struct frame *frame, *copy;
+
+	/* 제로 페이지에 대한 첫 쓰기입니다. 자기 프레임을 받아 0으로 채우고
+	 * 쓰기 가능하게 다시 매핑합니다. */
+	if (page_is_zero_fill (page)) {
+		lock_acquire (&frame_lock);
+		zero_mapped_cnt--;
+		zero_break_cnt++;
+		lock_release (&frame_lock);
+		return vm_do_claim_page (page);
+	}
+
+	lock_acquire (&frame_lock);
+	frame = page_wait_frame (page);
+	if (frame == NULL) {
+		/* 그 사이 축출되었습니다. 다시 올리면 쓰기 가능하게 매핑됩니다. */
+		lock_release (&frame_lock);
+		return vm_do_claim_page (page);
+	}
+	if (!frame_is_shared (frame)) {
+		cow_reuse_cnt++;
+		lock_release (&frame_lock);
+		return page_map (page, frame->kva, true);
+	}
+	frame->pinned = true;
+	lock_release (&frame_lock);
+
+	copy = vm_get_frame ();
+	if (copy == NULL) {
+		vm_unpin_frame (frame);
+		return false;
+	}
+	memcpy (copy->kva, frame->kva, PGSIZE);
+
+	lock_acquire (&frame_lock);
+	rmap_remove (frame, page);
+	rmap_add (copy, page);
+	frame->pinned = false;
+	cow_copy_cnt++;
+	cond_broadcast (&frame_cond, &frame_lock);
+	lock_release (&frame_lock);
+
+	if (!page_map (page, copy->kva, true)) {
+		vm_free_frame (copy);
+		return false;
+	}
+	vm_unpin_frame (copy);
+	return true;
 }
 
-/* Return true on success */
-bool
-vm_try_handle_fault (struct intr_frame *f UNUSED, void *addr UNUSED,
-		bool user UNUSED, bool write UNUSED, bool not_present UNUSED) {
-	struct supplemental_page_table *spt UNUSED = &thread_current ()->spt;
+/* PAGE의 프레임을 먼저 놓아 줍니다. 다시 읽어 올 수 있는 깨끗한 파일
+ * 페이지는 프레임을 바로 돌려주고, 나머지는 접근 비트를 꺼서 시계 바늘이
+ * 다른 프로세스의 페이지보다 먼저 고르게 합니다. */
+static void
+vm_deactivate_page (struct page *page) {
+	struct frame *frame;
+
+	lock_acquire (&frame_lock);
+	frame = page->frame;
+	if (frame == NULL || frame->pinned || frame_is_shared (frame)) {
+		lock_release (&frame_lock);
+		return;
+	}
+	if (page_get_type (page) != VM_FILE || frame_is_dirty (frame)) {
+		pml4_set_accessed (page->pml4, page->va, false);
+		lock_release (&frame_lock);
+		return;
+	}
+	frame->pinned = true;
+	drop_behind_cnt++;
+	lock_release (&frame_lock);
+	vm_free_frame (frame);
+}
+
+/* 순차 접근으로 알린 영역 VMA에서 VA에 폴트가 났을 때, 창 두 개 뒤의
+ * 창에 있는 페이지를 놓아 줍니다(drop-behind). 한 번만 읽고 지나가는
+ * 스트리밍 접근이 다른 프로세스의 작업 집합을 밀어내지 않게 합니다. */
+static void
+vm_drop_behind (struct supplemental_page_table *spt, struct vm_area *vma,
+		void *va) {
+	size_t behind = (uint8_t *) va - vma->start;
+
+	if (behind < 2 * FAULT_AROUND_MAX * PGSIZE)
+		return;
+	for (size_t k = FAULT_AROUND_MAX + 1; k <= 2 * FAULT_AROUND_MAX; k++) {
+		struct page *page = spt_find_page (spt,
+				(uint8_t *) va - k * PGSIZE);
+
+		if (page != NULL)
+			vm_deactivate_page (page);
+	}
+}
+
+/* 메모리에 없는 PAGE에 대한 폴트의 종류를 반환합니다. */
+static enum fault_class
+fault_class_of (struct page *page) {
+	switch (VM_TYPE (page->operations->type)) {
+		case VM_UNINIT:
+			return VM_TYPE (page->uninit.type) == VM_FILE
+				? FAULT_UNINIT_FILE : FAULT_UNINIT_ANON;
+		case VM_ANON:
+			return page_is_text (page) ? FAULT_FILE_REREAD : FAULT_SWAP_IN;
+		default:
+			return FAULT_FILE_REREAD;
+	}
+}
+
+/* vm_try_handle_fault()의 본체. SPT의 락을 쥔 상태에서 호출합니다.
+ * 처리한 폴트의 종류를 현재 스레드의 fault_class에 남깁니다. */
+static bool
+vm_handle_fault (struct intr_frame *f, void *addr, bool user, bool write,
+		bool not_present) {
+	struct thread *t = thread_current ();
+	struct supplemental_page_table *spt = &t->spt;
 	struct page *page = NULL;
-	/* TODO: Validate the fault */
-	
-	//예외 처리 - 커널 가상 메모리 범위에 존재, 읽기 전용 페이지 쓰기를 시도하는 경우
+	struct frame *frame;
+
+	/* 영역 안에서 처음 폴트가 난 주소라면 페이지를 만듭니다. */
+	page = spt_find_page (spt, addr);
+	if (page == NULL) {
+		struct vm_area *vma = spt_find_vma (spt, addr);
+
+		if (vma == NULL || !not_present || (write && !vma->writable))
+			return false;
+		if (vma->type & VM_STACK) {
+			/* 커널 모드 폴트라면 f->rsp는 커널 스택이므로 시스템 콜 진입 때
+			 * 저장해 둔 사용자 rsp를 씁니다. */
+			void *rsp = user ? (void *) f->rsp : t->user_rsp;
+
+			if (!is_stack_access (addr, rsp))
+				return false;
+			vm_stack_growth (addr);
+			page = spt_find_page (spt, addr);
+			t->fault_class = FAULT_STACK;
+		} else
+			page = vma_alloc_page (spt, vma, addr);
+		if (page == NULL)
+			return false;
+	}
+
+	/* 존재하는 페이지에 대한 폴트는 쓰기 보호 위반입니다. */
+	if (!not_present) {
+		t->fault_class = FAULT_COW;
+		return write && page->writable && vm_handle_wp (page);
+	}
+	if (write && !page->writable)
+		return false;
+	if (t->fault_class != FAULT_STACK)
+		t->fault_class = fault_class_of (page);
 
-	//1. 보조 페이지 테이블에서 해당 페이지 항목 찾기
-	//1-1 접근이 유효한지 확인
-	//1-2 해당 페이지 타입 확인
+	/* 다른 스레드가 이 페이지를 적재하거나 축출하는 중일 수 있습니다. */
+	lock_acquire (&frame_lock);
+	frame = page_wait_frame (page);
+	lock_release (&frame_lock);
+	if (frame != NULL)
+		return true;
 
-	//2. 페이지 타입에 따른 맞춤 처리
-	//2-1 익명 페이지 
-	//swap in / out을 해야 하는지 판단!
+	/* 쓰지 않은 익명 페이지를 읽기만 하면 제로 페이지로 충분합니다. */
+	if (!write && page_is_zero_fill (page)) {
+		if (!page_map (page, zero_page, false))
+			return false;
+		lock_acquire (&frame_lock);
+		zero_mapped_cnt++;
+		zero_fault_cnt++;
+		lock_release (&frame_lock);
+		return true;
+	}
+
+	/* 스왑 아웃된 익명 페이지는 이웃 슬롯을, 파일에서 읽어 올 페이지는
+	 * 같은 영역의 뒤따르는 페이지를 함께 올립니다. */
+	struct page *around[FAULT_AROUND_MAX];
+	size_t around_cnt, claimed;
+	bool swapped;
+
+	around_cnt = anon_swap_readahead (page, around, SWAP_READAHEAD);
+	swapped = around_cnt > 0;
+	if (!swapped)
+		around_cnt = vm_fault_around (page, around);
+
+	if (!vm_do_claim_page (page))
+		return false;
+	claimed = vm_claim_around (around, around_cnt);
 
-	//2-2 파일 페이지
-	//swap in / out을 해야 하는지 판단!
+	lock_acquire (&frame_lock);
+	if (swapped)
+		readahead_cnt += claimed;
+	else
+		fault_around_cnt += claimed;
+	lock_release (&frame_lock);
+
+	if (page->vma->advice == MADV_SEQUENTIAL)
+		vm_drop_behind (spt, page->vma, page->va);
+	return true;
+}
+
+/* Return true on success */
+bool
+vm_try_handle_fault (struct intr_frame *f UNUSED, void *addr UNUSED,
+		bool user UNUSED, bool write UNUSED, bool not_present UNUSED) {
+	struct supplemental_page_table *spt = &thread_current ()->spt;
+	bool success;
 
+	/* 커널 주소나 NULL 근처는 처리하지 않습니다. */
+	if (addr == NULL || !is_user_vaddr (addr))
+		return false;
 
-	return vm_do_claim_page (page);
+	/* 미리 읽기 스레드와 같은 페이지를 동시에 다루지 않도록 합니다. */
+	lock_acquire (&spt->lock);
+	success = vm_handle_fault (f, addr, user, write, not_present);
+	lock_release (&spt->lock);
+	return success;
 }
 
-/* Free the page.
- * DO NOT MODIFY THIS FUNCTION. */
+/* Free the page. */
 void
 vm_dealloc_page (struct page *page) {
+	struct frame *frame;
+
+	/* 축출 중이면 끝나기를 기다리고, 메모리에 있으면 파괴하는 동안
+	 * 축출되지 않게 고정합니다. 다른 페이지와 공유 중인 프레임은 공유
+	 * 목록에서 빠지기만 하고 해제하지 않습니다. */
+	lock_acquire (&frame_lock);
+	frame = page_wait_frame (page);
+	if (frame != NULL && (frame_is_shared (frame) || frame->text != NULL)) {
+		/* 캐시된 텍스트 프레임은 마지막 페이지가 없어져도 다음 exec를
+		 * 위해 주인 없이 남겨 둡니다. */
+		pml4_clear_page (page->pml4, page->va);
+		rmap_remove (frame, page);
+		frame = NULL;
+	} else if (frame != NULL)
+		frame->pinned = true;
+	else if (page_is_zero_mapped (page)) {
+		/* pml4_destroy()가 제로 페이지를 해제하지 않도록 매핑을 지웁니다. */
+		pml4_clear_page (page->pml4, page->va);
+		zero_mapped_cnt--;
+	}
+	lock_release (&frame_lock);
+
 	destroy (page);
-	free (page);
+	if (frame != NULL)
+		vm_free_frame (frame);
+	kmem_cache_free (&vm_page_cache, page);
 }
 
 /* Claim the page that allocate on VA. */
 bool
 vm_claim_page (void *va UNUSED) {
-	struct page *page = NULL;
-	/* TODO: Fill this function */
+	struct supplemental_page_table *spt = &thread_current ()->spt;
+	struct page *page;
+	bool success = false;
+
+	lock_acquire (&spt->lock);
+	page = spt_find_page (spt, va);
+	if (page == NULL) {
+		struct vm_area *vma = spt_find_vma (spt, va);
 
-	return vm_do_claim_page (page);
+		if (vma != NULL)
+			page = vma_alloc_page (spt, vma, va);
+	}
+	if (page != NULL)
+		success = vm_do_claim_page (page);
+	lock_release (&spt->lock);
+	return success;
 }
 
 /* Claim the PAGE and set up the mmu. */
 static bool
 vm_do_claim_page (struct page *page) {
-	struct frame *frame = vm_get_frame ();
+	bool text = page_is_text (page);
+	struct frame *frame;
+	bool loaded;
+
+	/* 같은 실행 파일의 이 페이지가 캐시에 있으면 읽지 않습니다. */
+	if (text && text_share (page))
+		return true;
+
+	frame = vm_get_frame ();
+	if (frame == NULL)
+		return false;
 
 	/* Set links */
-	frame->page = page;
-	page->frame = frame;
+	lock_acquire (&frame_lock);
+	rmap_add (frame, page);
+	lock_release (&frame_lock);
+
+	/* 내용을 다 채운 뒤에 매핑합니다. 축출되었던 텍스트 페이지는 스왑이
+	 * 아니라 실행 파일에서 다시 읽습니다. */
+	if (text && VM_TYPE (page->operations->type) == VM_ANON)
+		loaded = page->vma->init (page, page->vma);
+	else
+		loaded = swap_in (page, frame->kva);
+	if (!loaded || !page_map (page, frame->kva, page->writable)) {
+		vm_free_frame (frame);
+		return false;
+	}
+	if (text) {
+		lock_acquire (&frame_lock);
+		text_insert (frame, page);
+		lock_release (&frame_lock);
+	}
+	vm_unpin_frame (frame);
+	return true;
+}
+
+// 주어진 page 구조체의 가상 주소(va)를 기반으로 해시 값을 반환한다.
+static uint64_t
+page_hash (const struct hash_elem *elem, void *aux UNUSED){
+	const struct page *p = hash_entry(elem, struct page, hash_elem);
+	return hash_bytes (&p->va, sizeof p->va);
+}
 
-	/* TODO: Insert page table entry to map page's VA to frame's PA. */
+// page1의 가상 주소가 page2의 가상 주소보다 작으면 true를 반환한다. => page1이 더 "앞선다"
+static bool
+page_less (const struct hash_elem *elem1, const struct hash_elem *elem2, void *aux UNUSED){
+	const struct page *page1 = hash_entry(elem1, struct page, hash_elem);
+	const struct page *page2 = hash_entry(elem2, struct page, hash_elem);
 
-	return swap_in (page, frame->kva);
+	return page1->va < page2->va;
 }
 
-/* Initialize new supplemental page table 
+/* Initialize new supplemental page table
 보조 페이지 테이블을 초기화하는 함수
 */
 void
 supplemental_page_table_init (struct supplemental_page_table *spt UNUSED) {
 	hash_init(&spt->spt_hash, page_hash, page_less, NULL);
+	avl_init (&spt->vmas, vma_less, NULL);
+	lock_init (&spt->lock);
+}
+
+/* 부모의 페이지 SRC를 현재 스레드의 보조 페이지 테이블에 복제합니다.
+ * SRC가 속한 영역은 먼저 복제되어 있어야 합니다. 아직 적재되지 않은
+ * 페이지는 자식이 폴트를 낼 때 영역에서 다시 만들면 되므로 건너뜁니다.
+ * 익명 페이지는 프레임을 읽기 전용으로 공유하고(COW), 파일 페이지는
+ * 내용을 새 프레임에 복사합니다. 스왑 아웃된 페이지는 먼저 다시 올립니다. */
+static bool
+spt_copy_page (struct page *src) {
+	struct supplemental_page_table *spt = &thread_current ()->spt;
+	enum vm_type type = page_get_type (src);
+	struct frame *src_frame, *dst_frame;
+	struct page *dst;
+
+	if (VM_TYPE (src->operations->type) == VM_UNINIT)
+		return true;
+
+	if (!vm_alloc_page (type, src->va, src->writable))
+		return false;
+	dst = spt_find_page (spt, src->va);
+
+	src_frame = vm_pin_page (src);
+	if (src_frame == NULL)
+		return false;
+
+	if (type == VM_ANON) {
+		bool success;
+
+		anon_initializer (dst, VM_ANON, NULL);
+		lock_acquire (&frame_lock);
+		rmap_add (src_frame, dst);
+		cow_share_cnt++;
+		lock_release (&frame_lock);
+
+		/* 둘 다 읽기 전용으로 매핑해 먼저 쓰는 쪽이 vm_handle_wp로 오게
+		 * 합니다. */
+		success = page_map (src, src_frame->kva, false)
+			&& page_map (dst, src_frame->kva, false);
+		vm_unpin_frame (src_frame);
+		return success;
+	}
+
+	dst_frame = vm_pin_page (dst);
+	if (dst_frame == NULL) {
+		vm_unpin_frame (src_frame);
+		return false;
+	}
+
+	memcpy (dst_frame->kva, src_frame->kva, PGSIZE);
+	if (type == VM_FILE) {
+		dst->file = src->file;
+		pml4_set_dirty (dst->pml4, dst->va,
+				pml4_is_dirty (src->pml4, src->va));
+	}
+
+	vm_unpin_frame (dst_frame);
+	vm_unpin_frame (src_frame);
+	return true;
 }
 
 /* Copy supplemental page table from src to dst */
 bool
 supplemental_page_table_copy (struct supplemental_page_table *dst UNUSED,
 		struct supplemental_page_table *src UNUSED) {
+	uint64_t start = rdtsc ();
+	struct avl_elem *e;
+	bool success = true;
+
+	/* 영역을 복제한 뒤 그 영역에서 만들어진 페이지만 복제합니다. 부모의
+	 * 미리 읽기가 끼어들지 않도록 부모 테이블의 락을 쥡니다. */
+	lock_acquire (&src->lock);
+	for (e = avl_first (&src->vmas); success && e != NULL; e = avl_next (e)) {
+		struct vm_area *vma = avl_entry (e, struct vm_area, elem);
+		struct list_elem *pe;
+
+		if (!vm_alloc_region (vma->start, vma->end - vma->start, vma->type,
+					vma->writable, vma->init, vma->file, vma->ofs,
+					vma->read_bytes)) {
+			success = false;
+			break;
+		}
+		spt_find_vma (dst, vma->start)->advice = vma->advice;
+		for (pe = list_begin (&vma->pages); pe != list_end (&vma->pages);
+				pe = list_next (pe))
+			if (!spt_copy_page (list_entry (pe, struct page, vma_elem))) {
+				success = false;
+				break;
+			}
+	}
+	lock_release (&src->lock);
+	if (!success)
+		return false;
+
+	lock_acquire (&frame_lock);
+	fork_cnt++;
+	fork_pages += hash_size (&src->spt_hash);
+	fork_cycles += rdtsc () - start;
+	lock_release (&frame_lock);
+	return true;
+}
+
+/* 미리 읽기 요청 REQ의 범위에서 아직 메모리에 없는 페이지를 올립니다.
+ * 한 페이지마다 요청한 프로세스의 SPT 락을 쥐었다 놓으므로, 그 사이에
+ * 프로세스는 폴트를 처리하거나 영역을 없앨 수 있습니다. */
+static void
+prefetch_range (struct prefetch_req *req) {
+	struct supplemental_page_table *spt = req->spt;
+
+	for (uint8_t *va = req->start; va < req->end; va += PGSIZE) {
+		struct page *page;
+		bool stop, success = true;
+
+		lock_acquire (&prefetch_lock);
+		stop = prefetch_stop;
+		lock_release (&prefetch_lock);
+		if (stop)
+			break;
+
+		lock_acquire (&spt->lock);
+		page = spt_find_page (spt, va);
+		if (page != NULL && page->frame == NULL && !page_is_zero_fill (page)) {
+			success = vm_do_claim_page (page);
+			if (success)
+				prefetch_page_cnt++;
+		}
+		lock_release (&spt->lock);
+		if (!success)
+			break;
+	}
+}
+
+/* 미리 읽기 스레드. 큐에서 요청을 하나씩 꺼내 처리합니다. */
+static void
+vm_prefetcher (void *aux UNUSED) {
+	lock_acquire (&prefetch_lock);
+	for (;;) {
+		struct prefetch_req *req;
+
+		while (list_empty (&prefetch_queue))
+			cond_wait (&prefetch_cond, &prefetch_lock);
+		req = list_entry (list_pop_front (&prefetch_queue),
+				struct prefetch_req, elem);
+		prefetch_busy = req->spt;
+		lock_release (&prefetch_lock);
+
+		prefetch_range (req);
+		free (req);
+
+		lock_acquire (&prefetch_lock);
+		prefetch_busy = NULL;
+		prefetch_stop = false;
+		cond_broadcast (&prefetch_cond, &prefetch_lock);
+	}
+}
+
+/* SPT의 [START, END)를 미리 읽도록 요청합니다. 힌트일 뿐이므로 메모리가
+ * 모자라면 조용히 버립니다. */
+static void
+prefetch_enqueue (struct supplemental_page_table *spt, uint8_t *start,
+		uint8_t *end) {
+	struct prefetch_req *req = malloc (sizeof *req);
+
+	if (req == NULL)
+		return;
+	req->spt = spt;
+	req->start = start;
+	req->end = end;
+
+	lock_acquire (&prefetch_lock);
+	list_push_back (&prefetch_queue, &req->elem);
+	prefetch_req_cnt++;
+	cond_broadcast (&prefetch_cond, &prefetch_lock);
+	lock_release (&prefetch_lock);
+}
+
+/* SPT에 대한 미리 읽기 요청을 모두 지우고, 처리 중인 요청이 있으면 멈출
+ * 때까지 기다립니다. 이 함수가 돌아온 뒤에는 미리 읽기 스레드가 SPT를
+ * 건드리지 않습니다. */
+static void
+prefetch_cancel (struct supplemental_page_table *spt) {
+	struct list_elem *e;
+
+	lock_acquire (&prefetch_lock);
+	for (e = list_begin (&prefetch_queue); e != list_end (&prefetch_queue);) {
+		struct prefetch_req *req = list_entry (e, struct prefetch_req, elem);
+
+		if (req->spt == spt) {
+			e = list_remove (e);
+			free (req);
+		} else
+			e = list_next (e);
+	}
+	while (prefetch_busy == spt) {
+		prefetch_stop = true;
+		cond_wait (&prefetch_cond, &prefetch_lock);
+	}
+	lock_release (&prefetch_lock);
+}
+
+/* VMA의 [LO, HI)에서 파일 내용이 있는 페이지 중 아직 만들어지지 않은
+ * 것을 만들고 미리 읽기를 요청합니다. 0으로 채울 페이지는 올리지
+ * 않습니다. SPT의 락을 쥔 상태에서 호출합니다. */
+static void
+madvise_willneed (struct supplemental_page_table *spt, struct vm_area *vma,
+		uint8_t *lo, uint8_t *hi) {
+	for (uint8_t *va = lo; va < hi; va += PGSIZE)
+		if (vma->init != NULL && (size_t) (va - vma->start) < vma->read_bytes
+				&& spt_find_page (spt, va) == NULL
+				&& vma_alloc_page (spt, vma, va) == NULL)
+			return;
+	prefetch_enqueue (spt, lo, hi);
+}
+
+/* VMA의 [LO, HI)에서 만들어진 페이지를 모두 없앱니다. 수정된 파일 페이지는
+ * 파일에 쓰고, 다음 폴트에서 영역의 정보로 다시 만듭니다. 익명 페이지의
+ * 내용은 버려지므로 다시 0이나 실행 파일의 내용으로 채워집니다.
+ * SPT의 락을 쥔 상태에서 호출합니다. */
+static void
+madvise_dontneed (struct supplemental_page_table *spt, struct vm_area *vma,
+		uint8_t *lo, uint8_t *hi) {
+	struct list_elem *e = list_begin (&vma->pages);
+
+	while (e != list_end (&vma->pages)) {
+		struct page *page = list_entry (e, struct page, vma_elem);
+
+		e = list_next (e);
+		if ((uint8_t *) page->va >= lo && (uint8_t *) page->va < hi)
+			spt_remove_page (spt, page);
+	}
+	vma->fa.next = NULL;
+}
+
+/* 현재 프로세스의 [ADDR, ADDR + LENGTH)를 어떻게 쓸지 알립니다 (MADV_*).
+ * 범위의 모든 페이지가 어떤 영역 안에 있어야 합니다. MADV_NORMAL,
+ * MADV_RANDOM, MADV_SEQUENTIAL은 범위와 겹치는 영역 전체에 적용됩니다.
+ * 성공하면 0, 실패하면 -1을 반환합니다. */
+int
+vm_madvise (void *addr, size_t length, int advice) {
+	struct supplemental_page_table *spt = &thread_current ()->spt;
+	uint8_t *start = addr, *end, *va;
+	struct vm_area *vma;
+	int result = 0;
+
+	if (pg_ofs (addr) != 0 || length == 0
+			|| advice < MADV_NORMAL || advice > MADV_DONTNEED)
+		return -1;
+	end = start + ROUND_UP (length, PGSIZE);
+	if (end <= start || !is_user_vaddr (start) || !is_user_vaddr (end - 1))
+		return -1;
 
+	lock_acquire (&spt->lock);
+	for (va = start; va < end; va = vma->end)
+		if ((vma = spt_find_vma (spt, va)) == NULL) {
+			result = -1;
+			goto done;
+		}
+
+	for (va = start; va < end; va = vma->end) {
+		uint8_t *hi;
+
+		vma = spt_find_vma (spt, va);
+		hi = end < vma->end ? end : vma->end;
+		switch (advice) {
+			case MADV_WILLNEED:
+				madvise_willneed (spt, vma, va, hi);
+				break;
+			case MADV_DONTNEED:
+				madvise_dontneed (spt, vma, va, hi);
+				break;
+			default:
+				vma->advice = advice;
+				vma->fa.next = NULL;
+				break;
+		}
+	}
+done:
+	lock_release (&spt->lock);
+	return result;
+}
+
+/* 현재 프로세스의 VA 페이지를 올립니다. SPT의 락을 쥔 상태에서
+ * 호출합니다. 아직 만들어지지 않은 페이지는 영역에서 만들고, 영역 밖
+ * 주소와 이미 메모리에 있거나 0으로 채울 페이지는 건너뜁니다. 올렸으면 1,
+ * 건너뛰었으면 0, 페이지나 프레임을 얻지 못했으면 -1을 반환합니다. */
+static int
+populate_page (struct supplemental_page_table *spt, void *va) {
+	struct page *page;
+
+	if (!is_user_vaddr (va))
+		return 0;
+	page = spt_find_page (spt, va);
+	if (page == NULL) {
+		struct vm_area *vma = spt_find_vma (spt, va);
+
+		if (vma == NULL)
+			return 0;
+		if ((page = vma_alloc_page (spt, vma, va)) == NULL)
+			return -1;
+	}
+	if (page->frame != NULL || page_is_zero_fill (page))
+		return 0;
+	return vm_do_claim_page (page) ? 1 : -1;
+}
+
+/* 현재 프로세스의 PAGES[0..CNT)에 있는 페이지를 한꺼번에 올립니다.
+ * 주소 순으로 주면 파일을 앞에서부터 읽습니다. 올린 페이지 수를
+ * 반환합니다. */
+size_t
+vm_populate (void *const pages[], size_t cnt) {
+	struct supplemental_page_table *spt = &thread_current ()->spt;
+	size_t loaded = 0;
+
+	lock_acquire (&spt->lock);
+	for (size_t i = 0; i < cnt; i++) {
+		int r = populate_page (spt, pg_round_down (pages[i]));
+
+		if (r < 0)
+			break;
+		loaded += r;
+	}
+	lock_release (&spt->lock);
+	return loaded;
+}
+
+/* 현재 프로세스의 [ADDR, ADDR + LENGTH)를 앞에서부터 올리고 올린 페이지
+ * 수를 반환합니다. mmap(MAP_POPULATE)이 돌아오기 전에 부릅니다. */
+size_t
+vm_populate_range (void *addr, size_t length) {
+	struct supplemental_page_table *spt = &thread_current ()->spt;
+	uint8_t *va = pg_round_down (addr);
+	uint8_t *end = (uint8_t *) addr + length;
+	size_t loaded = 0;
+
+	lock_acquire (&spt->lock);
+	for (; va < end; va += PGSIZE) {
+		int r = populate_page (spt, va);
+
+		if (r < 0)
+			break;
+		loaded += r;
+	}
+	lock_release (&spt->lock);
+	return loaded;
 }
 
 /* Free the resource hold by the supplemental page table */
 void
 supplemental_page_table_kill (struct supplemental_page_table *spt UNUSED) {
-	/* TODO: Destroy all the supplemental_page_table hold by thread and
-	 * TODO: writeback all the modified contents to the storage. */
+	struct avl_elem *e;
+
+	prefetch_cancel (spt);
+
+	/* 모든 페이지는 어떤 영역에 속하므로 영역을 모두 없애면 테이블이
+	 * 빕니다. 수정된 파일 페이지는 각 페이지의 destroy에서 파일에 다시
+	 * 씁니다. exec()는 같은 테이블을 다시 씁니다. */
+	while ((e = avl_first (&spt->vmas)) != NULL)
+		vm_dealloc_region (avl_entry (e, struct vm_area, elem));
+	ASSERT (hash_empty (&spt->spt_hash));
+}
+
+/* 프레임 테이블과 축출 통계를 출력합니다. */
+void
+vm_print_stats (void) {
+	lock_acquire (&frame_lock);
+	printf ("Frames: %zu resident, %llu evictions "
+			"(%llu clean drops, %llu dirty writebacks), "
+			"%llu swap readahead\n",
+			frame_cnt, (unsigned long long) evict_cnt,
+			(unsigned long long) clean_drop_cnt,
+			(unsigned long long) dirty_writeback_cnt,
+			(unsigned long long) readahead_cnt);
+	printf ("Rmap: %llu shared frames evicted, %llu mappings unmapped, "
+			"%llu full TLB flushes\n",
+			(unsigned long long) shared_evict_cnt,
+			(unsigned long long) rmap_unmap_cnt,
+			(unsigned long long) tlb_flush_cnt);
+	printf ("Cleaner: %llu passes, %llu pages written back ahead of "
+			"eviction, watermark %u\n",
+			(unsigned long long) cleaner_pass_cnt,
+			(unsigned long long) cleaner_write_cnt, vm_clean_watermark);
+	printf ("Fault-around: %llu file faults, %llu pages mapped around "
+			"(faults avoided), max window %u\n",
+			(unsigned long long) file_fault_cnt,
+			(unsigned long long) fault_around_cnt, vm_fault_around_max);
+	printf ("Madvise: %llu prefetch requests, %llu pages prefetched, "
+			"%llu frames dropped behind\n",
+			(unsigned long long) prefetch_req_cnt,
+			(unsigned long long) prefetch_page_cnt,
+			(unsigned long long) drop_behind_cnt);
+	printf ("Zero page: %zu frames saved, %llu read faults served, "
+			"%llu replaced on write\n", zero_mapped_cnt,
+			(unsigned long long) zero_fault_cnt,
+			(unsigned long long) zero_break_cnt);
+	printf ("Text cache: %zu frames cached, %llu pages mapped from the cache, "
+			"%llu frames dropped\n", text_cached_cnt,
+			(unsigned long long) text_share_cnt,
+			(unsigned long long) text_evict_cnt);
+	if (vm_ksm_pages > 0)
+		printf ("KSM: %llu frames scanned, %llu frames merged, "
+				"%llu cycles spent, %u frames every %u ms\n",
+				(unsigned long long) ksm_scan_cnt,
+				(unsigned long long) ksm_merge_cnt,
+				(unsigned long long) ksm_cycles,
+				vm_ksm_pages, vm_ksm_sleep_ms);
+	if (fork_pages > 0) {
+		/* 주소 공간 1 MiB(256 페이지)당 평균 복제 사이클. */
+		uint64_t mib_cycles = fork_cycles * ((1 << 20) / PGSIZE) / fork_pages;
+		printf ("Fork: %llu forks, %llu pages, %llu cycles/MiB, "
+				"%llu frames shared, %llu COW copies, %llu COW reuses\n",
+				(unsigned long long) fork_cnt,
+				(unsigned long long) fork_pages,
+				(unsigned long long) mib_cycles,
+				(unsigned long long) cow_share_cnt,
+				(unsigned long long) cow_copy_cnt,
+				(unsigned long long) cow_reuse_cnt);
+	}
+	lock_release (&frame_lock);
+	swap_print_stats ();
+	zswap_print_stats ();
+	exec_trace_print_stats ();
 }
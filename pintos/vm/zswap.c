@@ -0,0 +1,397 @@
+/* zswap.c: Compressed in-memory cache in front of the swap disk. */
+
+#include "vm/zswap.h"
+#include <bitmap.h>
+#include <list.h>
+#include <round.h>
+#include <stdio.h>
+#include <string.h>
+#include "threads/malloc.h"
+#include "threads/palloc.h"
+#include "threads/synch.h"
+#include "threads/vaddr.h"
+#include "vm/vm.h"
+
+/* 압축 스왑 캐시.
+ *
+ * 익명 페이지를 축출할 때 스왑 디스크에 쓰기 전에 먼저 LZ 계열 압축기로
+ * 압축해 커널 풀의 고정된 영역(풀)에 보관합니다. 다시 폴트가 나면
+ * 디스크를 읽는 대신 풀에서 풀어 옵니다. 정렬된 배열이나 0이 많은 버퍼는
+ * 한 페이지가 수십~수백 바이트로 줄어듭니다.
+ *
+ * 풀은 ZSWAP_CHUNK 바이트 조각으로 나누어 비트맵으로 관리하고, 압축된
+ * 페이지 하나는 이어진 조각들을 차지합니다. 풀이 가득 차면 가장 오래전에
+ * 들어온 항목부터 풀어서 스왑 디스크에 쓰고(writeback) 자리를 비웁니다.
+ * 압축해도 ZSWAP_MAX_LEN보다 큰 페이지는 캐시하지 않고 바로 디스크에
+ * 씁니다.
+ *
+ * zswap_lock이 풀, 항목, 각 익명 페이지의 zentry, 압축 버퍼를 보호합니다.
+ * writeback은 락을 쥔 채 디스크에 씁니다. */
+
+/* 풀 조각의 크기 (바이트). */
+#define ZSWAP_CHUNK 64
+
+/* 캐시할 압축 페이지의 최대 길이. 이보다 덜 줄어드는 페이지는 압축할
+ * 가치가 없습니다. */
+#define ZSWAP_MAX_LEN (PGSIZE * 3 / 4)
+
+/* 압축된 페이지 하나. */
+struct zswap_entry {
+	struct page *page;          /* 이 항목에 내용이 있는 페이지 */
+	size_t chunk;               /* 풀에서 첫 조각의 번호 */
+	size_t len;                 /* 압축된 길이 (바이트) */
+	struct list_elem lru_elem;  /* zswap_lru의 원소 */
+};
+
+size_t zswap_pool_pages;
+
+static uint8_t *zswap_pool;             /* 풀, 쓰지 않으면 NULL */
+static struct bitmap *zswap_chunks;     /* 조각 사용 여부 */
+static struct list zswap_lru;           /* 항목들, 오래된 것부터 */
+static struct lock zswap_lock;
+
+/* 압축과 writeback에 쓰는 버퍼. zswap_lock이 보호합니다. */
+static uint8_t zswap_buf[PGSIZE];
+
+/* 통계. zswap_lock이 보호합니다. */
+static size_t stored_cnt;               /* 지금 풀에 있는 페이지 수 */
+static uint64_t store_cnt;              /* 풀에 넣은 페이지 수 */
+static uint64_t reject_cnt;             /* 잘 줄지 않아 디스크로 보낸 수 */
+static uint64_t full_cnt;               /* 풀을 비우지 못해 디스크로 보낸 수 */
+static uint64_t writeback_cnt;          /* 풀에서 디스크로 옮긴 수 */
+static uint64_t hit_cnt;                /* 풀에서 스왑 인한 수 */
+static uint64_t miss_cnt;               /* 디스크에서 스왑 인한 수 */
+static uint64_t in_bytes;               /* 압축 전 크기의 합 */
+static uint64_t out_bytes;              /* 압축 후 크기의 합 */
+
+/* LZ 압축기.
+ *
+ * LZ4 블록 형식을 따릅니다. 각 시퀀스는 토큰 바이트(상위 4비트는 리터럴
+ * 길이, 하위 4비트는 일치 길이 - LZ_MIN_MATCH), 리터럴, 2바이트 오프셋
+ * (리틀 엔디언)으로 이루어지고, 길이가 15 이상이면 255 단위 확장 바이트가
+ * 뒤따릅니다. 마지막 시퀀스는 리터럴만 있습니다. 입력은 항상 한 페이지라
+ * 오프셋은 16비트에 들어갑니다. 4바이트씩 해시해 직전에 같은 해시가 나온
+ * 위치와 비교하는 단순한 탐욕적 방식입니다. */
+
+#define LZ_MIN_MATCH 4
+#define LZ_HASH_BITS 12
+
+/* 4바이트 값마다 마지막으로 나온 위치. zswap_lock이 보호합니다. */
+static uint16_t lz_hash_table[1 << LZ_HASH_BITS];
+
+static inline uint32_t
+lz_load32 (const uint8_t *p) {
+	uint32_t v;
+
+	memcpy (&v, p, sizeof v);
+	return v;
+}
+
+static inline unsigned
+lz_hash (uint32_t v) {
+	return (v * 2654435761u) >> (32 - LZ_HASH_BITS);
+}
+
+/* 길이 확장 바이트를 OP에 쓰고 그 다음 위치를 반환합니다. */
+static uint8_t *
+lz_put_len (uint8_t *op, size_t len) {
+	if (len < 15)
+		return op;
+	for (len -= 15; len >= 255; len -= 255)
+		*op++ = 255;
+	*op++ = len;
+	return op;
+}
+
+/* 시퀀스 하나(LIT_LEN 바이트의 리터럴 LIT과, MATCH_LEN이 0이 아니면
+ * OFFSET 바이트 앞과의 일치)를 *OPP에 씁니다. OP_END를 넘으면 false. */
+static bool
+lz_emit (uint8_t **opp, uint8_t *op_end, const uint8_t *lit, size_t lit_len,
+		size_t offset, size_t match_len) {
+	size_t ml = match_len != 0 ? match_len - LZ_MIN_MATCH : 0;
+	uint8_t *op = *opp;
+	uint8_t *token;
+
+	if ((size_t) (op_end - op) < lit_len + lit_len / 255 + ml / 255 + 5)
+		return false;
+
+	token = op++;
+	*token = (lit_len < 15 ? lit_len : 15) << 4;
+	op = lz_put_len (op, lit_len);
+	memcpy (op, lit, lit_len);
+	op += lit_len;
+	if (match_len != 0) {
+		*op++ = offset & 0xff;
+		*op++ = offset >> 8;
+		*token |= ml < 15 ? ml : 15;
+		op = lz_put_len (op, ml);
+	}
+	*opp = op;
+	return true;
+}
+
+/* 한 페이지 SRC를 DST에 압축하고 길이를 반환합니다. DST_MAX 바이트
+ * 안에 들어가지 않으면 0을 반환합니다. */
+static size_t
+lz_compress (const uint8_t *src, uint8_t *dst, size_t dst_max) {
+	const uint8_t *end = src + PGSIZE;
+	const uint8_t *ip = src, *anchor = src;
+	uint8_t *op = dst, *op_end = dst + dst_max;
+
+	memset (lz_hash_table, 0, sizeof lz_hash_table);
+	while (ip + LZ_MIN_MATCH <= end) {
+		uint32_t v = lz_load32 (ip);
+		unsigned h = lz_hash (v);
+		const uint8_t *ref = src + lz_hash_table[h];
+		const uint8_t *mp, *rp;
+
+		lz_hash_table[h] = ip - src;
+		if (ref >= ip || lz_load32 (ref) != v) {
+			ip++;
+			continue;
+		}
+
+		for (mp = ip + LZ_MIN_MATCH, rp = ref + LZ_MIN_MATCH;
+				mp < end && *mp == *rp; mp++, rp++)
+			continue;
+		if (!lz_emit (&op, op_end, anchor, ip - anchor, ip - ref, mp - ip))
+			return 0;
+		ip = anchor = mp;
+	}
+	if (!lz_emit (&op, op_end, anchor, end - anchor, 0, 0))
+		return 0;
+	return op - dst;
+}
+
+/* 길이 확장 바이트를 읽어 *LEN에 더합니다. 입력이 끝나면 false. */
+static bool
+lz_get_len (const uint8_t **ipp, const uint8_t *ip_end, size_t *len) {
+	const uint8_t *ip = *ipp;
+	uint8_t b;
+
+	if (*len < 15)
+		return true;
+	do {
+		if (ip >= ip_end)
+			return false;
+		b = *ip++;
+		*len += b;
+	} while (b == 255);
+	*ipp = ip;
+	return true;
+}
+
+/* LEN 바이트의 압축 데이터 SRC를 풀어 한 페이지 DST를 채웁니다.
+ * 데이터가 잘못되었으면 false를 반환합니다. */
+static bool
+lz_decompress (const uint8_t *src, size_t len, uint8_t *dst) {
+	const uint8_t *ip = src, *ip_end = src + len;
+	uint8_t *op = dst, *op_end = dst + PGSIZE;
+
+	while (ip < ip_end) {
+		unsigned token = *ip++;
+		size_t lit = token >> 4;
+		size_t ml = token & 15;
+		size_t offset;
+
+		if (!lz_get_len (&ip, ip_end, &lit)
+				|| lit > (size_t) (ip_end - ip) || lit > (size_t) (op_end - op))
+			return false;
+		memcpy (op, ip, lit);
+		op += lit;
+		ip += lit;
+		if (ip == ip_end)
+			break;
+
+		if (ip_end - ip < 2)
+			return false;
+		offset = ip[0] | (ip[1] << 8);
+		ip += 2;
+		if (!lz_get_len (&ip, ip_end, &ml))
+			return false;
+		ml += LZ_MIN_MATCH;
+		if (offset == 0 || offset > (size_t) (op - dst)
+				|| ml > (size_t) (op_end - op))
+			return false;
+		/* 일치 구간이 자기 자신과 겹칠 수 있으므로 한 바이트씩 복사합니다. */
+		for (; ml > 0; ml--, op++)
+			*op = *(op - offset);
+	}
+	return op == op_end;
+}
+
+/* 풀에서 E의 데이터가 있는 위치. */
+static uint8_t *
+entry_data (struct zswap_entry *e) {
+	return zswap_pool + e->chunk * ZSWAP_CHUNK;
+}
+
+/* E를 풀에서 빼고 해제합니다. zswap_lock을 쥔 상태에서 호출합니다. */
+static void
+entry_free (struct zswap_entry *e) {
+	list_remove (&e->lru_elem);
+	bitmap_set_multiple (zswap_chunks, e->chunk,
+			DIV_ROUND_UP (e->len, ZSWAP_CHUNK), false);
+	e->page->anon.zentry = NULL;
+	stored_cnt--;
+	free (e);
+}
+
+/* 가장 오래된 항목을 풀어 스왑 디스크에 옮깁니다. 디스크에 자리가 없으면
+ * false를 반환합니다. zswap_lock을 쥔 상태에서 호출합니다. */
+static bool
+zswap_writeback (void) {
+	struct zswap_entry *e;
+
+	ASSERT (!list_empty (&zswap_lru));
+
+	e = list_entry (list_front (&zswap_lru), struct zswap_entry, lru_elem);
+	if (!lz_decompress (entry_data (e), e->len, zswap_buf))
+		PANIC ("zswap: corrupted entry");
+	if (!anon_swap_write (e->page, zswap_buf))
+		return false;
+	entry_free (e);
+	writeback_cnt++;
+	return true;
+}
+
+/* 압축 스왑 캐시를 초기화합니다. zswap_pool_pages가 0이면 쓰지 않습니다. */
+void
+zswap_init (void) {
+	list_init (&zswap_lru);
+	lock_init (&zswap_lock);
+	lock_set_name (&zswap_lock, "zswap_lock");
+	if (zswap_pool_pages == 0)
+		return;
+
+	zswap_pool = palloc_get_multiple (0, zswap_pool_pages);
+	zswap_chunks = bitmap_create (zswap_pool_pages * PGSIZE / ZSWAP_CHUNK);
+	if (zswap_pool == NULL || zswap_chunks == NULL) {
+		printf ("zswap: cannot allocate %zu pages, disabled\n",
+				zswap_pool_pages);
+		if (zswap_pool != NULL)
+			palloc_free_multiple (zswap_pool, zswap_pool_pages);
+		if (zswap_chunks != NULL)
+			bitmap_destroy (zswap_chunks);
+		zswap_pool = NULL;
+		zswap_pool_pages = 0;
+	}
+}
+
+/* 축출되는 익명 페이지 PAGE의 내용 KVA를 압축해 풀에 넣습니다. 풀이 가득
+ * 찼으면 오래된 항목을 디스크로 옮겨 자리를 만듭니다. 캐시를 쓰지 않거나,
+ * 잘 줄지 않거나, 자리를 만들 수 없으면 false를 반환하며, 그러면 호출자가
+ * 디스크에 써야 합니다. */
+bool
+zswap_store (struct page *page, const void *kva) {
+	struct zswap_entry *e;
+	size_t len, chunk;
+
+	if (zswap_pool == NULL)
+		return false;
+
+	lock_acquire (&zswap_lock);
+	len = lz_compress (kva, zswap_buf, ZSWAP_MAX_LEN);
+	if (len == 0) {
+		reject_cnt++;
+		goto fail;
+	}
+	while ((chunk = bitmap_scan_and_flip (zswap_chunks, 0,
+					DIV_ROUND_UP (len, ZSWAP_CHUNK), false)) == BITMAP_ERROR)
+		if (list_empty (&zswap_lru) || !zswap_writeback ()) {
+			full_cnt++;
+			goto fail;
+		}
+
+	e = malloc (sizeof *e);
+	if (e == NULL) {
+		bitmap_set_multiple (zswap_chunks, chunk,
+				DIV_ROUND_UP (len, ZSWAP_CHUNK), false);
+		goto fail;
+	}
+	e->page = page;
+	e->chunk = chunk;
+	e->len = len;
+	memcpy (entry_data (e), zswap_buf, len);
+	list_push_back (&zswap_lru, &e->lru_elem);
+	page->anon.zentry = e;
+
+	stored_cnt++;
+	store_cnt++;
+	in_bytes += PGSIZE;
+	out_bytes += len;
+	lock_release (&zswap_lock);
+	return true;
+
+fail:
+	lock_release (&zswap_lock);
+	return false;
+}
+
+/* PAGE의 내용이 풀에 있으면 KVA에 풀어 넣고 항목을 지운 뒤 true를
+ * 반환합니다. 없으면(디스크에 있으면) false를 반환합니다. */
+bool
+zswap_load (struct page *page, void *kva) {
+	struct zswap_entry *e;
+
+	if (zswap_pool == NULL)
+		return false;
+
+	lock_acquire (&zswap_lock);
+	e = page->anon.zentry;
+	if (e == NULL) {
+		miss_cnt++;
+		lock_release (&zswap_lock);
+		return false;
+	}
+	if (!lz_decompress (entry_data (e), e->len, kva))
+		PANIC ("zswap: corrupted entry");
+	entry_free (e);
+	hit_cnt++;
+	lock_release (&zswap_lock);
+	return true;
+}
+
+/* 파괴되는 PAGE의 항목이 풀에 있으면 지웁니다. 이 함수가 돌아온 뒤에는
+ * writeback이 PAGE를 건드리지 않습니다. */
+void
+zswap_invalidate (struct page *page) {
+	if (zswap_pool == NULL)
+		return;
+
+	lock_acquire (&zswap_lock);
+	if (page->anon.zentry != NULL)
+		entry_free (page->anon.zentry);
+	lock_release (&zswap_lock);
+}
+
+/* 압축 스왑 캐시의 사용량, 압축률, 적중률을 출력합니다. */
+void
+zswap_print_stats (void) {
+	uint64_t ratio, lookups;
+
+	if (zswap_pool == NULL)
+		return;
+
+	lock_acquire (&zswap_lock);
+	ratio = out_bytes > 0 ? in_bytes * 100 / out_bytes : 0;
+	lookups = hit_cnt + miss_cnt;
+	printf ("Zswap: %zu pages in %zu/%zu KiB pool, "
+			"%llu stores (%llu incompressible, %llu pool full), "
+			"ratio %llu.%02llu, %llu writebacks, "
+			"%llu hits, %llu misses (%llu%% hit rate)\n",
+			stored_cnt,
+			bitmap_count (zswap_chunks, 0, bitmap_size (zswap_chunks), true)
+				* ZSWAP_CHUNK / 1024,
+			zswap_pool_pages * PGSIZE / 1024,
+			(unsigned long long) store_cnt,
+			(unsigned long long) reject_cnt,
+			(unsigned long long) full_cnt,
+			(unsigned long long) (ratio / 100),
+			(unsigned long long) (ratio % 100),
+			(unsigned long long) writeback_cnt,
+			(unsigned long long) hit_cnt,
+			(unsigned long long) miss_cnt,
+			(unsigned long long) (lookups > 0 ? hit_cnt * 100 / lookups : 0));
+	lock_release (&zswap_lock);
+}